@@ -0,0 +1,33 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include "Graph.hpp"
+
+// runs one task per vertex of a DAG on a pool of workers, starting each task as soon as the
+// tasks of all its predecessors (vertices with an edge into it) have finished
+class DagExecutor {
+    private:
+    int numWorkers;
+    std::atomic<int> sleeping{0}; // workers of the current run waiting for a vertex
+
+    public:
+    // numWorkers <= 0 uses one worker per hardware thread
+    DagExecutor(int numWorkers = 0);
+
+    int workers(void) const;
+
+    // workers of the current run that are asleep waiting for a vertex to become ready; a task
+    // can read it while it runs (tests use it to check that idle workers do not spin)
+    int idleWorkers(void) const;
+
+    // call task(v) once for every vertex v of g, never before task(u) has returned for every
+    // edge (u, v); returns when all tasks are done
+    // if a task throws, no new tasks are started and the first exception is rethrown once the
+    // running ones have finished
+    // throw an std::invalid_argument exception if g has a cycle (the tasks that do not depend
+    // on the cycle are still run)
+    void run(const Graph &g, const std::function<void(int)> &task);
+};
+
+#include "DagExecutor.tpp"
@@ -0,0 +1,193 @@
+/*=================================================================================================
+File: DagExecutor.tpp
+Description:
+This file implements a work-stealing executor that runs a task per vertex of a directed acyclic
+graph, respecting the edges as dependencies.
+=================================================================================================*/
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include "DagExecutor.hpp"
+
+/*=================================================================================================
+Constructor: DagExecutor
+Description:
+    Creates an executor with a fixed number of workers.
+Parameters:
+    - int numWorkers: number of worker threads, <= 0 for one per hardware thread.
+=================================================================================================*/
+DagExecutor::DagExecutor(int numWorkers) : numWorkers(resolveThreadCount(numWorkers)) {}
+
+/*=================================================================================================
+Function: workers
+Description:
+    Number of worker threads used by run.
+Return:
+    - int: the worker count.
+=================================================================================================*/
+int DagExecutor::workers() const {
+    return numWorkers;
+}
+
+/*=================================================================================================
+Function: idleWorkers
+Description:
+    Workers of the current run sleeping on the condition variable in run.
+Return:
+    - int: the sleeping worker count, 0 outside run.
+=================================================================================================*/
+int DagExecutor::idleWorkers() const {
+    return sleeping.load();
+}
+
+/*=================================================================================================
+Function: run
+Description:
+    Work-stealing DAG execution. Every vertex has an atomic counter of unfinished predecessors.
+    Each worker owns a deque of ready vertices: it pushes and pops at the back (so a finished
+    task's successors run next, while their inputs are still in cache) and, when its deque is
+    empty, steals from the front of another worker's deque. After a task finishes, its
+    successors' counters are decremented and the worker that brings a counter to zero makes
+    that vertex ready.
+    pending counts vertices that are ready or running. A vertex is counted before its
+    predecessor is uncounted, so pending only reaches zero when no more work can appear,
+    which is when the workers stop. If fewer than n tasks ran by then, the rest are waiting on
+    a cycle.
+    A worker that finds no vertex anywhere sleeps on a condition variable until a vertex is
+    made ready (available > 0) or pending reaches zero. Producers only take the sleep lock to
+    notify when some worker is registered as sleeping; both sides use sequentially consistent
+    atomics, so either the producer sees the sleeper or the sleeper sees the new vertex.
+Parameters:
+    - const Graph& g: the dependency graph.
+    - const std::function<void(int)>& task: the work for a vertex.
+Return:
+    - nothing
+=================================================================================================*/
+void DagExecutor::run(const Graph &g, const std::function<void(int)> &task) {
+    struct WorkQueue {
+        std::mutex lock;
+        std::deque<int> ready;
+    };
+
+    CsrGraph csr = g.freeze();
+    int n = csr.numVertices();
+
+    // unfinished predecessors of each vertex
+    std::vector<std::atomic<int> > waiting(n);
+    for (int v = 0; v < n; ++v) {
+        waiting[v].store(0, std::memory_order_relaxed);
+    }
+    for (int u = 0; u < n; ++u) {
+        for (const int *it = csr.neighborsBegin(u); it != csr.neighborsEnd(u); ++it) {
+            waiting[*it].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // deal the vertices that can start right away round-robin to the workers
+    std::vector<WorkQueue> queues(numWorkers);
+    std::atomic<long long> pending(0);
+    std::atomic<long long> available(0); // vertices sitting in the deques
+    for (int v = 0, next = 0; v < n; ++v) {
+        if (waiting[v].load(std::memory_order_relaxed) == 0) {
+            queues[next].ready.push_back(v);
+            next = (next + 1) % numWorkers;
+            pending.fetch_add(1, std::memory_order_relaxed);
+            available.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::mutex idleLock;
+    std::condition_variable wake; // a vertex became ready, or pending reached zero
+    auto notify = [&](bool everyone) {
+        {
+            std::lock_guard<std::mutex> guard(idleLock); // a sleeper is either before its check or waiting
+        }
+        if (everyone) {
+            wake.notify_all();
+        } else {
+            wake.notify_one();
+        }
+    };
+
+    std::atomic<int> completed(0);
+    std::atomic<bool> failed(false);
+    std::exception_ptr error;
+    std::mutex errorLock;
+
+    runOnThreads(numWorkers, [&](int t) {
+        while (true) {
+            int v = -1;
+
+            // newest vertex from our own deque first
+            {
+                std::lock_guard<std::mutex> guard(queues[t].lock);
+                if (!queues[t].ready.empty()) {
+                    v = queues[t].ready.back();
+                    queues[t].ready.pop_back();
+                }
+            }
+            // otherwise steal the oldest vertex from someone else
+            for (int i = 1; v == -1 && i < numWorkers; ++i) {
+                WorkQueue &victim = queues[(t + i) % numWorkers];
+                std::lock_guard<std::mutex> guard(victim.lock);
+                if (!victim.ready.empty()) {
+                    v = victim.ready.front();
+                    victim.ready.pop_front();
+                }
+            }
+
+            if (v == -1) {
+                std::unique_lock<std::mutex> guard(idleLock);
+                sleeping.fetch_add(1);
+                wake.wait(guard, [&]() { return available.load() > 0 || pending.load() == 0; });
+                sleeping.fetch_sub(1);
+                if (available.load() == 0 && pending.load() == 0) {
+                    return; // nothing ready, nothing running: all done
+                }
+                continue;
+            }
+            available.fetch_sub(1);
+
+            if (!failed.load(std::memory_order_relaxed)) {
+                try {
+                    task(v);
+                    completed.fetch_add(1, std::memory_order_relaxed);
+
+                    // release the successors whose last predecessor was v
+                    for (const int *it = csr.neighborsBegin(v); it != csr.neighborsEnd(v); ++it) {
+                        if (waiting[*it].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                            pending.fetch_add(1, std::memory_order_relaxed);
+                            {
+                                std::lock_guard<std::mutex> guard(queues[t].lock);
+                                queues[t].ready.push_back(*it);
+                            }
+                            available.fetch_add(1);
+                            if (sleeping.load() > 0) {
+                                notify(false);
+                            }
+                        }
+                    }
+                } catch (...) {
+                    std::lock_guard<std::mutex> guard(errorLock);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                    failed.store(true, std::memory_order_relaxed);
+                }
+            }
+            if (pending.fetch_sub(1) == 1) {
+                notify(true); // last running task: let the sleepers exit
+            }
+        }
+    });
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    if (completed.load() != n) {
+        throw std::invalid_argument("DagExecutor: graph has a cycle");
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include "Graph.hpp"
+
+// exact hop-distance queries from a 2-hop labeling built with pruned landmark labeling
+// every vertex v stores an out-label (hubs h with their distance d(v, h)) and an in-label
+// (hubs h with d(h, v)); d(s, t) is the smallest d(s, h) + d(h, t) over hubs the two labels
+// share, found by merging two short sorted lists
+// the index is a snapshot: later changes to the graph are not reflected
+class DistanceIndex {
+    private:
+    struct LabelEntry {
+        int hub; // rank of the hub vertex (0 = highest degree)
+        int distance;
+    };
+
+    std::vector<std::vector<LabelEntry> > outLabel;
+    std::vector<std::vector<LabelEntry> > inLabel;
+
+    // used by load
+    DistanceIndex(void);
+
+    public:
+    DistanceIndex(const Graph &g);
+
+    int numVertices(void) const;
+
+    // total number of label entries, a measure of the index size
+    long long labelSize(void) const;
+
+    // number of edges on a shortest path from s to t, INT_MAX if t is not reachable
+    // same as breadthFirstSearch(s)[t].distance
+    // throw an std::out_of_range exception if s or t is not in the graph
+    int distance(int s, int t) const;
+
+    // write the index in a versioned binary format
+    // throw an std::runtime_error exception if writing fails
+    void save(std::ostream &out) const;
+
+    // read an index written by save
+    // throw an std::invalid_argument exception if the data is not a valid index
+    static DistanceIndex load(std::istream &in);
+};
+
+#include "DistanceIndex.tpp"
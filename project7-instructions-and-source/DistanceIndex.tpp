@@ -0,0 +1,245 @@
+/*=================================================================================================
+File: DistanceIndex.tpp
+Description:
+This file implements pruned landmark labeling (Akiba, Iwata, Yoshida) for exact shortest hop
+distances on directed graphs, with binary serialization of the finished index.
+=================================================================================================*/
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include "DistanceIndex.hpp"
+
+/*=================================================================================================
+Constructor: DistanceIndex
+Description:
+    Pruned landmark labeling. Vertices are processed as hubs in decreasing order of total
+    degree, since high-degree vertices lie on many shortest paths. For hub k:
+      - a forward BFS from k gives d(k, u); u gets (k, d) in its in-label unless the labels
+        built so far already answer d(k, u) <= d, in which case the BFS is also not continued
+        past u (every shortest path through u is already covered)
+      - a backward BFS over in-edges does the same for out-labels
+    Pruning makes later BFSs tiny, so the labels stay small. To make the pruning test cheap,
+    hub k's own label is spread into an array indexed by hub rank before each BFS.
+Parameters:
+    - const Graph& g: the graph to index.
+=================================================================================================*/
+DistanceIndex::DistanceIndex(const Graph &g) {
+    const int INF = std::numeric_limits<int>::max();
+    CsrGraph forward = g.freeze();
+    CsrGraph backward = forward.transpose();
+    int n = forward.numVertices();
+    outLabel.assign(n, std::vector<LabelEntry>());
+    inLabel.assign(n, std::vector<LabelEntry>());
+
+    // hub order: highest total degree first
+    std::vector<int> byRank(n);
+    for (int v = 0; v < n; ++v) {
+        byRank[v] = v;
+    }
+    std::stable_sort(byRank.begin(), byRank.end(), [&](int a, int b) {
+        return forward.outDegree(a) + backward.outDegree(a) > forward.outDegree(b) + backward.outDegree(b);
+    });
+
+    std::vector<int> hubDistance(n, INF); // hub's own label, indexed by hub rank
+    std::vector<int> distance(n, INF); // BFS distances, reset through the queue
+    std::vector<int> queue;
+
+    // one pruned BFS from the hub of rank k over edges; own holds the hub's labels on the
+    // side the BFS starts from, found the labels that reached vertices get
+    auto prunedBFS = [&](int k, const CsrGraph &edges, const std::vector<std::vector<LabelEntry> > &own,
+                         std::vector<std::vector<LabelEntry> > &found) {
+        int hub = byRank[k];
+        for (const LabelEntry &e : own[hub]) {
+            hubDistance[e.hub] = e.distance;
+        }
+
+        queue.clear();
+        queue.push_back(hub);
+        distance[hub] = 0;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            int u = queue[head];
+            int d = distance[u];
+
+            // can the existing labels already answer the hub-u distance?
+            bool covered = false;
+            for (const LabelEntry &e : found[u]) {
+                if (hubDistance[e.hub] != INF && hubDistance[e.hub] + e.distance <= d) {
+                    covered = true;
+                    break;
+                }
+            }
+            if (covered) {
+                continue;
+            }
+
+            found[u].push_back(LabelEntry{k, d});
+            for (const int *it = edges.neighborsBegin(u); it != edges.neighborsEnd(u); ++it) {
+                if (distance[*it] == INF) {
+                    distance[*it] = d + 1;
+                    queue.push_back(*it);
+                }
+            }
+        }
+
+        for (int u : queue) {
+            distance[u] = INF;
+        }
+        for (const LabelEntry &e : own[hub]) {
+            hubDistance[e.hub] = INF;
+        }
+    };
+
+    for (int k = 0; k < n; ++k) {
+        // forward: d(hub, u) = d(hub, h) [hub's out-label] + d(h, u) [u's in-label]
+        prunedBFS(k, forward, outLabel, inLabel);
+        // backward: d(u, hub) = d(u, h) [u's out-label] + d(h, hub) [hub's in-label]
+        prunedBFS(k, backward, inLabel, outLabel);
+    }
+}
+
+/*=================================================================================================
+Constructor: DistanceIndex (private)
+Description:
+    Empty index, filled in by load.
+=================================================================================================*/
+DistanceIndex::DistanceIndex() {}
+
+/*=================================================================================================
+Function: numVertices / labelSize
+Description:
+    Size of the indexed graph and of the index itself.
+Return:
+    - the number of vertices / the total number of label entries.
+=================================================================================================*/
+int DistanceIndex::numVertices() const {
+    return outLabel.size();
+}
+
+long long DistanceIndex::labelSize() const {
+    long long total = 0;
+    for (int v = 0; v < numVertices(); ++v) {
+        total += outLabel[v].size() + inLabel[v].size();
+    }
+    return total;
+}
+
+/*=================================================================================================
+Function: distance
+Description:
+    Merges s's out-label with t's in-label (both sorted by hub rank) and keeps the best sum.
+Parameters:
+    - int s: the start vertex.
+    - int t: the target vertex.
+Return:
+    - int: the hop distance from s to t, INT_MAX if t is not reachable.
+=================================================================================================*/
+int DistanceIndex::distance(int s, int t) const {
+    if (s < 0 || s >= numVertices() || t < 0 || t >= numVertices()) {
+        throw std::out_of_range("distance: vertex index out of range");
+    }
+    const std::vector<LabelEntry> &a = outLabel[s];
+    const std::vector<LabelEntry> &b = inLabel[t];
+    int best = INT_MAX;
+    size_t i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        if (a[i].hub < b[j].hub) {
+            ++i;
+        } else if (a[i].hub > b[j].hub) {
+            ++j;
+        } else {
+            best = std::min(best, a[i].distance + b[j].distance);
+            ++i;
+            ++j;
+        }
+    }
+    return best;
+}
+
+/*=================================================================================================
+Function: save
+Description:
+    Writes the index as: 8-byte magic "GRAPHPLL", uint32 format version, uint32 vertex count,
+    then for every vertex its out-label and in-label, each as a uint32 entry count followed by
+    (int32 hub, int32 distance) pairs. Integers are written in the machine's byte order.
+Parameters:
+    - std::ostream& out: where to write (should be opened in binary mode).
+Return:
+    - nothing
+=================================================================================================*/
+void DistanceIndex::save(std::ostream &out) const {
+    auto writeU32 = [&](std::uint32_t x) { out.write(reinterpret_cast<const char *>(&x), sizeof(x)); };
+
+    out.write("GRAPHPLL", 8);
+    writeU32(1); // format version
+    writeU32(numVertices());
+    for (int v = 0; v < numVertices(); ++v) {
+        const std::vector<LabelEntry> *labels[2] = {&outLabel[v], &inLabel[v]};
+        for (const std::vector<LabelEntry> *label : labels) {
+            writeU32(label->size());
+            for (const LabelEntry &e : *label) {
+                std::int32_t pair[2] = {e.hub, e.distance};
+                out.write(reinterpret_cast<const char *>(pair), sizeof(pair));
+            }
+        }
+    }
+    if (!out) {
+        throw std::runtime_error("DistanceIndex: write failed");
+    }
+}
+
+/*=================================================================================================
+Function: load
+Description:
+    Reads an index written by save, checking the magic, version and that every hub is in range.
+Parameters:
+    - std::istream& in: where to read from (should be opened in binary mode).
+Return:
+    - DistanceIndex: the loaded index.
+=================================================================================================*/
+DistanceIndex DistanceIndex::load(std::istream &in) {
+    auto readU32 = [&]() {
+        std::uint32_t x = 0;
+        if (!in.read(reinterpret_cast<char *>(&x), sizeof(x))) {
+            throw std::invalid_argument("DistanceIndex: truncated index data");
+        }
+        return x;
+    };
+
+    char magic[8];
+    if (!in.read(magic, 8) || std::memcmp(magic, "GRAPHPLL", 8) != 0) {
+        throw std::invalid_argument("DistanceIndex: not a distance index");
+    }
+    if (readU32() != 1) {
+        throw std::invalid_argument("DistanceIndex: unsupported format version");
+    }
+    std::uint32_t n = readU32();
+
+    DistanceIndex index;
+    index.outLabel.resize(n);
+    index.inLabel.resize(n);
+    for (std::uint32_t v = 0; v < n; ++v) {
+        std::vector<LabelEntry> *labels[2] = {&index.outLabel[v], &index.inLabel[v]};
+        for (std::vector<LabelEntry> *label : labels) {
+            std::uint32_t count = readU32();
+            if (count > n) {
+                throw std::invalid_argument("DistanceIndex: corrupt label");
+            }
+            label->resize(count);
+            for (LabelEntry &e : *label) {
+                std::int32_t pair[2];
+                if (!in.read(reinterpret_cast<char *>(pair), sizeof(pair))) {
+                    throw std::invalid_argument("DistanceIndex: truncated index data");
+                }
+                if (pair[0] < 0 || static_cast<std::uint32_t>(pair[0]) >= n || pair[1] < 0) {
+                    throw std::invalid_argument("DistanceIndex: corrupt label");
+                }
+                e.hub = pair[0];
+                e.distance = pair[1];
+            }
+        }
+    }
+    return index;
+}
@@ -3,6 +3,13 @@
 #include <iostream>
 #include <vector>
 #include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <type_traits>
+#include "Parallel.hpp"
 
 struct TraversalData {
     bool visited;
@@ -19,17 +26,238 @@ struct TraversalData {
     };
 };
 
+// result of Graph::shortestPath
+struct PathResult {
+    int distance; // number of edges, INT_MAX if there is no path
+    std::vector<int> path; // s, ..., t (empty if there is no path)
+};
+
+// vertex labels produced by the components algorithms
+struct ComponentResult {
+    std::vector<int> component; // component id of each vertex, 0 ... count - 1
+    std::vector<int> sizes; // number of vertices in each component
+    int count;
+};
+
+// outputs Graph::breadthFirstSearchFields can compute, combined with |
+struct TraversalFields {
+    static const unsigned Visited = 1;
+    static const unsigned Parent = 2;
+    static const unsigned Distance = 4;
+};
+
+// structure-of-arrays BFS result that only stores the fields asked for
+// visited is a bitset (empty unless Fields has Visited, so only call visited() then), parent is
+// an int32 array (empty unless Fields has Parent) and distance uses DistanceT (empty unless
+// Fields has Distance), with numeric_limits<DistanceT>::max() as infinity
+template <unsigned Fields, typename DistanceT = std::int32_t>
+struct TraversalResult {
+    static_assert(std::is_integral<DistanceT>::value, "DistanceT must be an integer type");
+
+    std::vector<std::uint64_t> visitedBits;
+    std::vector<std::int32_t> parent;
+    std::vector<DistanceT> distance;
+
+    bool visited(int v) const {
+        return (visitedBits[v >> 6] >> (v & 63)) & 1;
+    }
+};
+
+// strategies for Graph::breadthFirstSearch, all give the same visited/distance results
+// TopDown expands each frontier vertex's out-edges (parents match a queue-based BFS)
+// DirectionOptimizing switches to scanning in-edges of unvisited vertices when the frontier is
+// large (parents are still valid BFS parents but may differ from TopDown)
+enum class BfsMode { TopDown, DirectionOptimizing };
+
+class Graph;
+template <typename W>
+class WeightedGraph;
+
+// reusable scratch space for Graph traversals from a single source
+// pass the same workspace to many breadthFirstSearch/depthFirstSearch calls: results are
+// stamped with the run number (epoch), so starting a new run is O(1) and a run only writes the
+// vertices it reaches
+class TraversalWorkspace {
+    private:
+    std::vector<TraversalData> data;
+    std::vector<unsigned> stamp; // data[v] belongs to the current run iff stamp[v] == epoch
+    unsigned epoch = 0;
+    std::vector<int> visitedList; // vertices reached in the current run, in visit order
+    std::vector<std::pair<int, size_t> > stack; // DFS scratch
+
+    // start a new run on a graph with n vertices
+    void start(int n);
+
+    // true if v was reached in the current run
+    bool seen(int v) const;
+
+    // mark v as reached in the current run and return its entry to fill in
+    TraversalData& visit(int v);
+
+    friend class Graph;
+
+    public:
+    TraversalWorkspace(void);
+
+    // true if v was reached in the last run
+    // throw an std::out_of_range exception if v is not a vertex of the last graph used
+    bool visited(int v) const;
+
+    // traversal data of v from the last run; vertices that were not reached report
+    // visited = false, parent = -1 and distance = INT_MAX
+    // throw an std::out_of_range exception if v is not a vertex of the last graph used
+    TraversalData get(int v) const;
+
+    // vertices reached in the last run, in the order they were reached
+    const std::vector<int>& reached(void) const;
+};
+
+// read-only compressed sparse row (CSR) snapshot of a Graph, produced by Graph::freeze()
+// the neighbors of u are targets[offsets[u]] ... targets[offsets[u + 1] - 1], in the same
+// order as the adjacency list they were built from, so traversals give identical results
+class CsrGraph {
+    private:
+    // keeps the arrays alive: owned vectors for freeze()/transpose(), a file mapping for
+    // MappedGraph; the snapshot is immutable, so copies share it
+    std::shared_ptr<const void> storage;
+    const long long *offsets; // n + 1 entries
+    const int *targets; // one entry per edge
+    int n;
+    long long m;
+
+    // only Graph::freeze() and MappedGraph build snapshots
+    CsrGraph(std::vector<long long> offsets, std::vector<int> targets);
+    CsrGraph(std::shared_ptr<const void> storage, const long long *offsets, const int *targets, int n, long long m);
+
+    friend class Graph;
+    friend class MappedGraph;
+
+    public:
+    int numVertices(void) const;
+
+    long long numEdges(void) const;
+
+    // return true if u is in the graph, false otherwise
+    bool vertexIn(int u) const;
+
+    // throw an std::out_of_range exception if u is not in the graph
+    int outDegree(int u) const;
+
+    // pointer range over the neighbors of u, no bounds checking
+    const int* neighborsBegin(int u) const;
+    const int* neighborsEnd(int u) const;
+
+    // snapshot of the reversed graph (every edge (u, v) becomes (v, u))
+    // the neighbors of each vertex are listed in increasing order
+    CsrGraph transpose(void) const;
+
+    // same results as Graph::breadthFirstSearch
+    // throw an std::out_of_range exception if s is not in graph
+    std::vector<TraversalData> breadthFirstSearch(int s) const;
+
+    // same results as Graph::depthFirstSearch, including the topological order labels
+    std::vector<TraversalData> depthFirstSearch(void) const;
+};
+
 class Graph {
     private:
     // assume vertices are 0...n-1;
     std::vector<std::vector<int> > adjList; // adjacency list
 
+    // open-addressing hash set of a vertex's neighbors (linear probing, power of two capacity)
+    // only built for vertices whose out-degree reached indexThreshold
+    struct EdgeIndex {
+        std::vector<int> slots; // -1 = empty, -2 = deleted, otherwise a neighbor
+        int used = 0; // slots that are not empty (neighbors + deleted markers)
+
+        static size_t home(int v, size_t mask);
+        bool contains(int v) const;
+        void insert(int v);
+        bool erase(int v);
+        void rebuild(const std::vector<int> &neighbors);
+    };
+    std::vector<EdgeIndex> edgeIndex; // one per vertex while the index is enabled, empty otherwise
+    int indexThreshold = 0; // 0 means the index is disabled
+
+    // reverse adjacency (in-edges), built on first use and then kept up to date by
+    // addEdge/removeEdge
+    std::vector<std::vector<int> > revList;
+    bool revValid = false;
+
+    // return the in-edge lists, building them if needed
+    const std::vector<std::vector<int> >& inEdges(void);
+
+    // online topological order (Pearce-Kelly), kept up to date by addEdge while enabled
+    bool topoEnabled = false;
+    std::vector<int> topoPosition; // position of each vertex in the order
+    std::vector<int> topoVertex; // vertex at each position
+    std::vector<char> topoMark; // scratch marks for the searches, all 0 between calls
+
+    // restore the order before inserting (u, v) when u currently comes after v
+    // throw an std::invalid_argument exception if v reaches u (the edge would close a cycle)
+    void reorderForEdge(int u, int v);
+
+    // Beamer-style top-down/bottom-up BFS, used by BfsMode::DirectionOptimizing
+    std::vector<TraversalData> directionOptimizingBFS(int s);
+
     // order is a variable used to keep track of the position of the last element placed in the topological ordering
-    void dfsVisit(std::vector<TraversalData> &data, int &time, int u, int &order);
+    // stack is scratch space for the explicit DFS stack, reused across calls
+    void dfsVisit(std::vector<TraversalData> &data, int &time, int u, int &order,
+                  std::vector<std::pair<int, size_t> > &stack);
+
+    // topologicalLevels on threads the caller already has, so a caller that also works level by
+    // level (WeightedGraph::dagPaths) keeps one set of threads for both
+    std::vector<std::vector<int> > topologicalLevels(ThreadTeam &team) const;
+
+    // graph with the edges of blocks[0], blocks[1], ... in that order, built with a parallel
+    // counting sort by source; later copies of an edge are dropped, so each neighbor list is in
+    // order of first occurrence, exactly as if addEdge had been called for every edge
+    // if placement is set, (*placement)[i] is the index of input edge i in its source's list
+    // throw an std::out_of_range exception if an edge uses a vertex that is not in the graph
+    static Graph fromEdgeBlocks(int n, const std::vector<std::pair<int, int> > *blocks, size_t numBlocks,
+                                int numThreads, std::vector<int> *placement = nullptr);
+
+    // readFromBuffer, with caller (readFromSTDIN, readFromStream or readFromBuffer) naming the
+    // function the user called in the error messages
+    static Graph parseEdgeList(const char *begin, const char *end,
+                               const std::function<void(long long, long long)> &progress,
+                               long long progressInterval, const char *caller);
+
+    // helpers shared by the "n m" edge-list loaders (parallelReadFromBuffer, readGzip); all
+    // throw the same exceptions as parallelReadFromBuffer, with caller naming the loader
+    // parseHeader reads "n m" at p and moves p past it, returning false if it is missing or
+    // out of range; parseEdgeLines appends the edges on whole "u v" lines to edges and throws
+    // at the first bad line; fromParsedBlocks keeps the first m edges of the buffers, rethrows
+    // a buffer's parse error only if it falls within them, and builds the graph
+    static bool parseHeader(const char *&p, const char *end, long long &n, long long &m);
+    static void parseEdgeLines(const char *begin, const char *end, long long n,
+                               std::vector<std::pair<int, int> > &edges, const char *caller);
+    static Graph fromParsedBlocks(long long n, long long m, std::vector<std::vector<std::pair<int, int> > > &blocks,
+                                  const std::vector<std::exception_ptr> &errors, int numThreads,
+                                  const char *caller);
+
+    // calls f(lineNumber, begin, end) for every line of in (without the '\n'), reading the
+    // stream in large blocks; line numbers start at 1
+    template <typename F>
+    static void forEachLine(std::istream &in, F f);
+
+    // skips blanks and parses an integer at p, moving p past it; on failure returns false and
+    // leaves p at the first non-blank character (end if the rest of the line is blank)
+    static bool nextInteger(const char *&p, const char *end, long long &value);
+
+    template <typename W>
+    friend class WeightedGraph;
 
     public:
     Graph(int n);
 
+    // graph with the given edges, built in bulk on numThreads threads (<= 0 uses all hardware
+    // threads) instead of one addEdge call per edge; repeated edges are dropped and every
+    // neighbor list is in order of first occurrence, the same graph addEdge would build
+    // throw an std::invalid_argument exception if n < 0
+    // throw an std::out_of_range exception if an edge uses a vertex that is not in the graph
+    static Graph fromEdges(int n, const std::vector<std::pair<int, int> > &edges, int numThreads = 0);
+
     Graph(const Graph &g);
 
     ~Graph(void);
@@ -37,14 +265,31 @@ class Graph {
     Graph& operator=(const Graph &g);
 
     // return true if u is in the graph, false otherwise
-    bool vertexIn(int u);
+    bool vertexIn(int u) const;
 
     // throw an std::out_of_range exception if u or v is not in the graph
-    bool edgeIn(int u, int v);
+    bool edgeIn(int u, int v) const;
+
+    int numVertices(void) const;
+
+    // out-neighbors of u, in the order their edges were added
+    // throw an std::out_of_range exception if u is not in the graph
+    const std::vector<int>& neighbors(int u) const;
 
     // throw an std::out_of_range exception if u or v is not in the graph
     void addEdge(int u, int v);
 
+    // keep a hash index of the neighbors of every vertex with at least threshold out-edges
+    // so edgeIn, addEdge and removeEdge's existence check no longer scan long neighbor lists
+    // neighbor order (and so traversal order) is unchanged
+    // throw an std::invalid_argument exception if threshold < 1
+    void enableEdgeIndex(int threshold = 32);
+
+    void disableEdgeIndex(void);
+
+    // the remaining neighbors keep their order (traversals and WeightedGraph's weights rely
+    // on it), so removing an edge costs O(degree of u) even with the edge index; the index
+    // only makes removing a missing edge O(1)
     // throw an std::out_of_range exception if u or v is not in the graph
     // throw an std::out_of_range exception if (u, v) is not an edge of the graph
     void removeEdge(int u, int v);
@@ -54,13 +299,159 @@ class Graph {
     // throw an std::out_of_range exception if s is not in graph
     // use -1 as NIL
     // use INT_MAX as infinity
-    std::vector<TraversalData> breadthFirstSearch(int s);
+    std::vector<TraversalData> breadthFirstSearch(int s, BfsMode mode = BfsMode::TopDown);
+
+    // level-synchronous BFS where each frontier is split across numThreads threads
+    // (numThreads <= 0 uses all hardware threads)
+    // distances always match breadthFirstSearch; parents are any valid BFS parent unless
+    // deterministic is set, in which case all results match breadthFirstSearch exactly
+    // throw an std::out_of_range exception if s is not in graph
+    std::vector<TraversalData> parallelBreadthFirstSearch(int s, int numThreads = 0, bool deterministic = false);
+
+    // same as breadthFirstSearch(s), but only computes and stores the outputs selected by
+    // Fields (see TraversalFields / TraversalResult), e.g.
+    //     g.breadthFirstSearchFields<TraversalFields::Distance, std::uint8_t>(s)
+    // throw an std::out_of_range exception if s is not in graph
+    // throw an std::overflow_error exception if a distance does not fit in DistanceT
+    template <unsigned Fields, typename DistanceT = std::int32_t>
+    TraversalResult<Fields, DistanceT> breadthFirstSearchFields(int s);
+
+    // same as breadthFirstSearch(s), with the results left in ws (see TraversalWorkspace)
+    // cost is proportional to the part of the graph reached from s
+    // throw an std::out_of_range exception if s is not in graph
+    void breadthFirstSearch(int s, TraversalWorkspace &ws);
+
+    // fewest-edges path from s to t, found with a bidirectional BFS (out-edges from s, in-edges
+    // from t) that stops as soon as the two searches meet
+    // throw an std::out_of_range exception if s or t is not in graph
+    PathResult shortestPath(int s, int t);
+
+    // same, reusing two workspaces so the cost is proportional to the vertices touched
+    PathResult shortestPath(int s, int t, TraversalWorkspace &forward, TraversalWorkspace &backward);
+
+    // BFS distances from many sources at once; result[i][v] is the distance from sources[i]
+    // to v (INT_MAX if unreachable), same as breadthFirstSearch(sources[i])[v].distance
+    // sources are processed 64 at a time, sharing one scan of the edges per level
+    // throw an std::out_of_range exception if a source is not in graph
+    std::vector<std::vector<int> > multiSourceBFS(const std::vector<int> &sources);
 
     // assume vertices are traversed in numerical order
     // implement this without use the "colors" approach
     std::vector<TraversalData> depthFirstSearch(void);
 
+    // vertices in topological order (the vertex with order 1 first), taken from depthFirstSearch
+    // throw an std::invalid_argument exception if the graph has a cycle
+    std::vector<int> topologicalSort(void);
+
+    // Kahn-style topological sort by dependency level: level 0 holds the vertices with no
+    // in-edges, level i the vertices whose in-edges all come from levels < i
+    // vertices within a level do not depend on each other and are listed in increasing order
+    // each level is processed across numThreads threads (<= 0 uses all hardware threads)
+    // throw an std::invalid_argument exception if the graph has a cycle
+    std::vector<std::vector<int> > topologicalLevels(int numThreads = 0) const;
+
+    // keep a topological order up to date while edges are added (see topologicalOrder)
+    // from then on addEdge throws an std::invalid_argument exception, and leaves the graph
+    // unchanged, if the new edge would create a cycle
+    // throw an std::invalid_argument exception if the graph already has a cycle
+    void enableTopologicalOrder(void);
+
+    void disableTopologicalOrder(void);
+
+    // the maintained topological order (vertex sequence)
+    // throw an std::logic_error exception if enableTopologicalOrder has not been called
+    const std::vector<int>& topologicalOrder(void) const;
+
+    // DFS of the vertices reachable from s only, with the results left in ws
+    // discovery/finish times start at 1 and order numbers the k reached vertices 1...k
+    // throw an std::out_of_range exception if s is not in graph
+    void depthFirstSearch(int s, TraversalWorkspace &ws);
+
+    // strongly connected components with an iterative Tarjan's algorithm
+    // components are numbered in reverse topological order of the condensation (a component
+    // only has edges to components with smaller ids)
+    ComponentResult stronglyConnectedComponents(void) const;
+
+    // the same components found with a parallel trim + forward-backward decomposition
+    // (numThreads <= 0 uses all hardware threads); components are numbered in order of their
+    // smallest vertex
+    ComponentResult parallelStronglyConnectedComponents(int numThreads = 0);
+
+    // weakly connected components (edge direction ignored) with a parallel Afforest-style
+    // union-find (numThreads <= 0 uses all hardware threads); components are numbered in order
+    // of their smallest vertex
+    ComponentResult weaklyConnectedComponents(int numThreads = 0);
+
+    // graph with one vertex per component and an edge (a, b) whenever some edge of this graph
+    // goes from component a to a different component b
+    // throw an std::invalid_argument exception if components does not label this graph's vertices
+    Graph condensation(const ComponentResult &components) const;
+
+    // build an immutable CSR snapshot of the current edges
+    // later changes to this graph are not reflected in the snapshot
+    CsrGraph freeze(void) const;
+
+    // called during loading with (edges read so far, total edges from the header)
+    typedef std::function<void(long long, long long)> ProgressCallback;
+
+    // read "n m" followed by m "u v" pairs from standard input
+    // throw an std::invalid_argument exception if the input is malformed or truncated
+    // throw an std::out_of_range exception if an edge uses a vertex that is not in the graph
     static Graph readFromSTDIN();
+
+    // same format and exceptions as readFromSTDIN
+    // progress (if set) is called at most once every progressInterval edges, and once at the end
+    static Graph readFromStream(std::istream &in, const ProgressCallback &progress = ProgressCallback(),
+                                long long progressInterval = 1 << 20);
+
+    // parse the same format from text already in memory
+    static Graph readFromBuffer(const char *begin, const char *end,
+                                const ProgressCallback &progress = ProgressCallback(),
+                                long long progressInterval = 1 << 20);
+
+    // parse "n m" followed by one "u v" edge per line on numThreads threads (<= 0 uses all
+    // hardware threads): the text is cut into chunks at line breaks, each chunk is parsed into
+    // its own edge buffer, and the buffers are merged by fromEdgeBlocks
+    // unlike readFromBuffer, each edge must be on a line of its own; for such input it gives
+    // the same graph, and lines after the first m edges are ignored without being checked
+    // throw an std::invalid_argument exception if one of the first m edge lines is not a single
+    // "u v" pair or there are fewer than m edges
+    // throw an std::out_of_range exception if one of the first m edges uses a vertex that is not
+    // in the graph
+    static Graph parallelReadFromBuffer(const char *begin, const char *end, int numThreads = 0);
+
+    // parallelReadFromBuffer over the file mapped into memory with mmap
+    // throw an std::runtime_error exception if the file cannot be opened or mapped
+    static Graph parallelReadFromFile(const std::string &path, int numThreads = 0);
+
+#ifdef GRAPH_WITH_ZLIB
+    // gzip-compressed edge list in the parallelReadFromBuffer format (plain text files are read
+    // as is), loaded as a pipeline: one thread decompresses with zlib and passes line-aligned
+    // blocks to numThreads - 1 parser threads (at least one) while it keeps decompressing, and
+    // the parsed blocks are built into the graph with fromEdgeBlocks
+    // same exceptions as parallelReadFromBuffer, plus
+    // throw an std::runtime_error exception if the file cannot be opened or is corrupt
+    static Graph readGzip(const std::string &path, int numThreads = 0);
+#endif
+
+    // readers for common dataset formats, streaming the input and building the graph with
+    // fromEdges (numThreads as there); errors name the offending line
+    // throw an std::invalid_argument exception if the input is malformed
+    // throw an std::out_of_range exception if an edge uses a vertex outside the declared size
+
+    // SNAP edge list: "u v" per line with 0-based ids, '#' comment lines, no header; the graph
+    // has max id + 1 vertices and extra columns after u v are ignored
+    static Graph readSNAP(std::istream &in, int numThreads = 0);
+
+    // Matrix Market coordinate file: entry (i, j) becomes edge i-1 -> j-1 on max(rows, cols)
+    // vertices; symmetric, skew-symmetric and hermitian matrices also get j-1 -> i-1, and
+    // entry values are ignored
+    static Graph readMatrixMarket(std::istream &in, int numThreads = 0);
+
+    // METIS graph file: "n m [fmt [ncon]]" then one line of 1-based neighbors per vertex
+    // (vertex sizes and weights and edge weights, if fmt declares them, are skipped); every
+    // undirected edge is listed at both ends, so it becomes a pair of directed edges
+    static Graph readMETIS(std::istream &in, int numThreads = 0);
 };
 
 #include "Graph.tpp"
\ No newline at end of file
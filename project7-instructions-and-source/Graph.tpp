@@ -12,6 +12,24 @@ and edges. It also provides implementations for Breadth-First Search (BFS) and D
 #include <limits>
 #include <queue>
 #include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cctype>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef GRAPH_WITH_ZLIB
+#include <zlib.h>
+#endif
 #include "Graph.hpp"
 
 /*=================================================================================================
@@ -28,12 +46,15 @@ Graph::Graph(int n) : adjList(n) {}
 /*=================================================================================================
 Copy Constructor: Graph
 Description:
-    Creates a new graph by copying the adjacency list from another graph.
+    Creates a new graph by copying the adjacency list (and edge index, if any) from another graph.
 Parameters:
     - const Graph& g: the graph to copy from.
 =================================================================================================*/
 
-Graph::Graph(const Graph &g) : adjList(g.adjList) {}
+Graph::Graph(const Graph &g)
+    : adjList(g.adjList), edgeIndex(g.edgeIndex), indexThreshold(g.indexThreshold), revList(g.revList),
+      revValid(g.revValid), topoEnabled(g.topoEnabled), topoPosition(g.topoPosition), topoVertex(g.topoVertex),
+      topoMark(g.topoMark) {}
 
 /*=================================================================================================
 Destructor: ~Graph
@@ -47,7 +68,7 @@ Graph::~Graph() {}
 /*=================================================================================================
 Assignment Operator: operator=
 Description:
-    Assigns the contents of one graph to another by copying the adjacency list.
+    Assigns the contents of one graph to another by copying the adjacency list and edge index.
     It checks for self-assignment to prevent unnecessary copying.
 Parameters:
     - const Graph& g: the graph to assign from.
@@ -57,6 +78,14 @@ Return:
 Graph& Graph::operator=(const Graph &g) {
     if (this != &g) {
         adjList = g.adjList;
+        edgeIndex = g.edgeIndex;
+        indexThreshold = g.indexThreshold;
+        revList = g.revList;
+        revValid = g.revValid;
+        topoEnabled = g.topoEnabled;
+        topoPosition = g.topoPosition;
+        topoVertex = g.topoVertex;
+        topoMark = g.topoMark;
     }
     return *this;
 }
@@ -71,7 +100,7 @@ Parameters:
 Return:
     - bool: true if vertex u is valid, false otherwise.
 =================================================================================================*/
-bool Graph::vertexIn(int u) {
+bool Graph::vertexIn(int u) const {
      // If u is within the valid range of vertex indices
     if (u >= 0 && u < static_cast<int>(adjList.size())) {
         return true; // u is a valid vertex
@@ -84,17 +113,22 @@ bool Graph::vertexIn(int u) {
 Function: edgeIn
 Description:
     Checks whether a directed edge exists from vertex u to vertex v in the graph.
-    First ensures both vertices are valid. Then searches u's neighbor list to see if v is present.
+    First ensures both vertices are valid. Then looks v up in u's edge index if u has one,
+    otherwise searches u's neighbor list to see if v is present.
 Parameters:
     - int u: the source vertex.
     - int v: the target vertex.
 Return:
     - bool: true if an edge from u to v exists, false otherwise.
 =================================================================================================*/
-bool Graph::edgeIn(int u, int v) {
+bool Graph::edgeIn(int u, int v) const {
     if (!vertexIn(u) || !vertexIn(v)) { //checking if the two vertices exist in the graoh 
         throw std::out_of_range("edgeIn: vertex index out of range");
     }
+    // high-degree vertices answer from their hash index
+    if (indexThreshold > 0 && !edgeIndex[u].slots.empty()) {
+        return edgeIndex[u].contains(v);
+    }
     //iterate through the adj list of vertex u 
     for (int neighbor : adjList[u]) {
         //if list has v the vertex from u to v already exists
@@ -105,12 +139,41 @@ bool Graph::edgeIn(int u, int v) {
     return false;
 }
 
+/*=================================================================================================
+Function: numVertices
+Description:
+    Number of vertices in the graph.
+Return:
+    - int: the vertex count n (vertices are 0 ... n-1).
+=================================================================================================*/
+int Graph::numVertices() const {
+    return adjList.size();
+}
+
+/*=================================================================================================
+Function: neighbors
+Description:
+    Read-only access to a vertex's adjacency list.
+Parameters:
+    - int u: the vertex.
+Return:
+    - const std::vector<int>&: the out-neighbors of u.
+=================================================================================================*/
+const std::vector<int>& Graph::neighbors(int u) const {
+    if (!vertexIn(u)) {
+        throw std::out_of_range("neighbors: vertex index out of range");
+    }
+    return adjList[u];
+}
+
 /*=================================================================================================
 Function: addEdge
 Description:
     Adds a directed edge from vertex u to vertex v in the graph.
     The function first checks whether both vertices exist. If the edge does not already exist,
-    it is added to u's adjacency list.
+    it is added to u's adjacency list. When the edge index is enabled, u's index is built once
+    its degree reaches the threshold and kept up to date afterwards. When the topological order
+    is maintained, it is repaired first, and an edge that would close a cycle is rejected.
 Parameters:
     - int u: the source vertex.
     - int v: the destination vertex.
@@ -123,7 +186,23 @@ void Graph::addEdge(int u, int v) {
     }
     //add the edge if the edge does not exist already 
     if (!edgeIn(u, v)) {
+        // fix the topological order (or reject the edge) before changing anything
+        if (topoEnabled && topoPosition[u] >= topoPosition[v]) {
+            reorderForEdge(u, v);
+        }
+
         adjList[u].push_back(v); // Add v to u's list of neighbors
+
+        if (indexThreshold > 0) {
+            if (!edgeIndex[u].slots.empty()) {
+                edgeIndex[u].insert(v); // already indexed, just add v
+            } else if (static_cast<int>(adjList[u].size()) >= indexThreshold) {
+                edgeIndex[u].rebuild(adjList[u]); // u just became a high-degree vertex
+            }
+        }
+        if (revValid) {
+            revList[v].push_back(u); // keep the in-edges in sync
+        }
     }
 }
 /*=================================================================================================
@@ -132,6 +211,10 @@ Description:
     Removes a directed edge from vertex u to vertex v in the graph.
     The function first checks whether both vertices exist. Then, it searches for v in u’s
     adjacency list and removes it if found. If the edge does not exist, an exception is thrown.
+    Indexed vertices reject missing edges without scanning. An existing edge is still found
+    and erased in O(degree), because the remaining neighbors keep their order: swapping the
+    last neighbor into the hole would change traversal order and misalign WeightedGraph's
+    weights.
 Parameters:
     - int u: the source vertex.
     - int v: the destination vertex to remove from u's adjacency list.
@@ -139,31 +222,202 @@ Return:
     - void: this function does not return a value.
 =================================================================================================*/
 void Graph::removeEdge(int u, int v) {
+    if (!vertexIn(u) || !vertexIn(v)) { 
+            throw std::out_of_range("removeEdge: vertex index out of range");
+        }
     //list of neighbors for vertex u
     std::vector<int>& neighbors = adjList[u];
-    if (!vertexIn(u) || !vertexIn(v)) { 
-            throw std::out_of_range("addEdge: vertex index out of range");
+
+    // an indexed vertex knows right away whether the edge is there
+    if (indexThreshold > 0 && !edgeIndex[u].slots.empty() && !edgeIndex[u].erase(v)) {
+        throw std::out_of_range("removeEdge: edge does not exist");
+    }
+
+    // Find v in the list (there are no duplicate edges, so the first match is the only one)
+    std::vector<int>::iterator it = std::find(neighbors.begin(), neighbors.end(), v);
+
+    // If v was never found, throw an exception
+    if (it == neighbors.end()) {
+        throw std::out_of_range("removeEdge: edge does not exist");
+    }
+    // Remove it, keeping the other neighbors in order
+    neighbors.erase(it);
+
+    // keep the in-edges in sync
+    if (revValid) {
+        std::vector<int>& in = revList[v];
+        in.erase(std::find(in.begin(), in.end(), u));
+    }
+}
+
+/*=================================================================================================
+Function: enableEdgeIndex
+Description:
+    Turns on hash indexing of neighbor lists. Every vertex whose out-degree is at least
+    threshold gets an open-addressing hash set of its neighbors, which makes edgeIn, addEdge and
+    the existence check in removeEdge O(1) expected instead of O(degree) (the removal itself
+    stays O(degree) to keep neighbor order). Low-degree vertices
+    keep using the plain scan, which is faster for short lists.
+Parameters:
+    - int threshold: the out-degree at which a vertex gets an index.
+Return:
+    - nothing
+=================================================================================================*/
+void Graph::enableEdgeIndex(int threshold) {
+    if (threshold < 1) {
+        throw std::invalid_argument("enableEdgeIndex: threshold must be at least 1");
+    }
+    indexThreshold = threshold;
+    edgeIndex.assign(adjList.size(), EdgeIndex());
+
+    // index the vertices that are already over the threshold
+    for (size_t u = 0; u < adjList.size(); ++u) {
+        if (static_cast<int>(adjList[u].size()) >= threshold) {
+            edgeIndex[u].rebuild(adjList[u]);
+        }
+    }
+}
+
+/*=================================================================================================
+Function: disableEdgeIndex
+Description:
+    Drops all neighbor indexes and goes back to scanning neighbor lists.
+Parameters:
+    - none
+Return:
+    - nothing
+=================================================================================================*/
+void Graph::disableEdgeIndex() {
+    indexThreshold = 0;
+    std::vector<EdgeIndex>().swap(edgeIndex); // release the memory
+}
+
+/*=================================================================================================
+Function: EdgeIndex::home
+Description:
+    Hashes a vertex id to its first probe slot. The bits are mixed before masking so ids with
+    the same low bits (e.g. multiples of a power of two) do not pile up in one run.
+Parameters:
+    - int v: the neighbor to hash.
+    - size_t mask: table capacity - 1.
+Return:
+    - size_t: the slot to start probing from.
+=================================================================================================*/
+size_t Graph::EdgeIndex::home(int v, size_t mask) {
+    unsigned x = static_cast<unsigned>(v);
+    x = ((x >> 16) ^ x) * 0x45d9f3bu;
+    x = ((x >> 16) ^ x) * 0x45d9f3bu;
+    x = (x >> 16) ^ x;
+    return x & mask;
+}
+
+/*=================================================================================================
+Function: EdgeIndex::contains
+Description:
+    Probes for v starting at its hash slot until v or an empty slot is found. Deleted markers
+    are stepped over since v may have been placed after them.
+Parameters:
+    - int v: the neighbor to look for.
+Return:
+    - bool: true if v is in the set.
+=================================================================================================*/
+bool Graph::EdgeIndex::contains(int v) const {
+    size_t mask = slots.size() - 1;
+    size_t i = home(v, mask);
+    while (slots[i] != -1) {
+        if (slots[i] == v) {
+            return true;
         }
+        i = (i + 1) & mask;
+    }
+    return false;
+}
 
-    // Tracker - so we can track whether we erased the edge  
-    bool found = false;
+/*=================================================================================================
+Function: EdgeIndex::insert
+Description:
+    Adds v to the set (the caller guarantees it is not already there). The table is grown
+    before it gets more than half full, counting deleted markers, so probes stay short.
+Parameters:
+    - int v: the neighbor to add.
+Return:
+    - nothing
+=================================================================================================*/
+void Graph::EdgeIndex::insert(int v) {
+    if (2 * (used + 1) > static_cast<int>(slots.size())) {
+        // collect the live entries and rehash them into a bigger table
+        std::vector<int> live;
+        for (int x : slots) {
+            if (x >= 0) {
+                live.push_back(x);
+            }
+        }
+        live.push_back(v);
+        rebuild(live);
+        return;
+    }
+    size_t mask = slots.size() - 1;
+    size_t i = home(v, mask);
+    while (slots[i] >= 0) {
+        i = (i + 1) & mask;
+    }
+    if (slots[i] == -1) {
+        ++used; // reusing a deleted marker does not use up a new slot
+    }
+    slots[i] = v;
+}
 
-    // Loop through each neighbor
-    for (size_t i = 0; i < neighbors.size(); ++i) {
-        //if we see v 
-        if (neighbors[i] == v) {
-            // Remove the neighbor at position i
-            neighbors.erase(neighbors.begin() + i);
-            found = true;
-            // The loop will still continue, but we only want to remove the first match
-            i = neighbors.size(); //to end the loop
+/*=================================================================================================
+Function: EdgeIndex::erase
+Description:
+    Removes v from the set by replacing it with a deleted marker.
+Parameters:
+    - int v: the neighbor to remove.
+Return:
+    - bool: true if v was in the set.
+=================================================================================================*/
+bool Graph::EdgeIndex::erase(int v) {
+    size_t mask = slots.size() - 1;
+    size_t i = home(v, mask);
+    while (slots[i] != -1) {
+        if (slots[i] == v) {
+            slots[i] = -2;
+            return true;
         }
+        i = (i + 1) & mask;
     }
-    // If v was never found, throw an exception
-    if (!found) {
-        throw std::out_of_range("removeEdge: edge does not exist");
+    return false;
+}
+
+/*=================================================================================================
+Function: EdgeIndex::rebuild
+Description:
+    Rebuilds the set from scratch with capacity for at least twice the given neighbors,
+    dropping any deleted markers.
+Parameters:
+    - const std::vector<int>& neighbors: the full set of neighbors to store.
+Return:
+    - nothing
+=================================================================================================*/
+void Graph::EdgeIndex::rebuild(const std::vector<int> &neighbors) {
+    size_t capacity = 16;
+    while (capacity < 2 * neighbors.size()) {
+        capacity *= 2;
+    }
+    slots.assign(capacity, -1);
+    used = 0;
+
+    size_t mask = capacity - 1;
+    for (int v : neighbors) {
+        size_t i = home(v, mask);
+        while (slots[i] != -1) {
+            i = (i + 1) & mask;
+        }
+        slots[i] = v;
+        ++used;
     }
 }
+
 /*=================================================================================================
 Function: breadthFirstSearch
 Description:
@@ -171,15 +425,20 @@ Description:
     Tracks visited status, parent for each vertex, and the distance from the source.
 Parameters:
     - int s: the source vertex to start BFS from.
+    - BfsMode mode: TopDown (the queue-based BFS below) or DirectionOptimizing.
 Return:
     - std::vector<TraversalData>: a vector containing traversal data for each vertex,
       including visited status, parent, and distance from the source.
 =================================================================================================*/      
-std::vector<TraversalData> Graph::breadthFirstSearch(int s) {
+std::vector<TraversalData> Graph::breadthFirstSearch(int s, BfsMode mode) {
     // Check if the starting vertex exists in the graph
     if (!vertexIn(s)) 
     throw std::out_of_range("BFS: source not in graph");
 
+    if (mode == BfsMode::DirectionOptimizing) {
+        return directionOptimizingBFS(s);
+    }
+
     // Get the number of vertices in the graph
     int n = adjList.size();
 
@@ -219,6 +478,550 @@ std::vector<TraversalData> Graph::breadthFirstSearch(int s) {
     // Return the BFS result for all vertices
     return data;
 }
+/*=================================================================================================
+Function: inEdges
+Description:
+    Returns the reverse adjacency list (for each vertex, the vertices with an edge into it).
+    It is built the first time it is needed; after that addEdge and removeEdge keep it in sync
+    so it never has to be rebuilt.
+Parameters:
+    - none
+Return:
+    - const std::vector<std::vector<int>>&: the in-edge lists.
+=================================================================================================*/
+const std::vector<std::vector<int> >& Graph::inEdges() {
+    if (!revValid) {
+        int n = adjList.size();
+        std::vector<int> inDegree(n, 0);
+        for (int u = 0; u < n; ++u) {
+            for (int v : adjList[u]) {
+                ++inDegree[v];
+            }
+        }
+        revList.assign(n, std::vector<int>());
+        for (int v = 0; v < n; ++v) {
+            revList[v].reserve(inDegree[v]);
+        }
+        for (int u = 0; u < n; ++u) {
+            for (int v : adjList[u]) {
+                revList[v].push_back(u);
+            }
+        }
+        revValid = true;
+    }
+    return revList;
+}
+
+/*=================================================================================================
+Function: directionOptimizingBFS
+Description:
+    Direction-optimizing BFS (Beamer, Asanovic, Patterson). Small frontiers are expanded
+    top-down over out-edges. When the out-edges of the frontier outnumber the unexplored edges
+    by more than 1/ALPHA, it switches to bottom-up steps: every unvisited vertex scans its
+    in-edges and stops at the first one coming from the frontier. It switches back once the
+    frontier has shrunk below n/BETA and stopped growing.
+    Distances are the same as the top-down BFS; a bottom-up step picks the first frontier
+    in-neighbor as parent, which is a valid BFS parent but not always the queue-order one.
+Parameters:
+    - int s: the source vertex (already checked to be in the graph).
+Return:
+    - std::vector<TraversalData>: visited status, parent, and distance from s for each vertex.
+=================================================================================================*/
+std::vector<TraversalData> Graph::directionOptimizingBFS(int s) {
+    const long long ALPHA = 15; // top-down -> bottom-up switch factor
+    const long long BETA = 18; // bottom-up -> top-down switch factor
+
+    int n = adjList.size();
+    const std::vector<std::vector<int> >& in = inEdges();
+
+    std::vector<TraversalData> data(n);
+    long long edgesToCheck = 0; // out-edges of vertices not yet visited
+    for (int i = 0; i < n; ++i) {
+        data[i].visited = false;
+        data[i].parent = -1;
+        data[i].distance = std::numeric_limits<int>::max();
+        edgesToCheck += adjList[i].size();
+    }
+
+    data[s].visited = true;
+    data[s].distance = 0;
+    std::vector<int> frontier(1, s);
+    long long scoutCount = adjList[s].size(); // out-edges of the current frontier
+    int level = 0;
+
+    // bitmaps for the bottom-up steps
+    std::vector<char> inFrontier(n, 0);
+    std::vector<char> inNext(n, 0);
+
+    while (!frontier.empty()) {
+        if (scoutCount > edgesToCheck / ALPHA) {
+            // switch to bottom-up: move the frontier into a bitmap
+            std::fill(inFrontier.begin(), inFrontier.end(), 0);
+            for (int u : frontier) {
+                inFrontier[u] = 1;
+            }
+            long long awake = frontier.size();
+            long long oldAwake;
+            do {
+                oldAwake = awake;
+                awake = 0;
+                ++level;
+                std::fill(inNext.begin(), inNext.end(), 0);
+                for (int v = 0; v < n; ++v) {
+                    if (data[v].visited) {
+                        continue;
+                    }
+                    // look for any parent in the frontier, stop at the first one
+                    for (int u : in[v]) {
+                        if (inFrontier[u]) {
+                            data[v].visited = true;
+                            data[v].parent = u;
+                            data[v].distance = level;
+                            inNext[v] = 1;
+                            ++awake;
+                            break;
+                        }
+                    }
+                }
+                inFrontier.swap(inNext);
+            } while (awake > 0 && (awake >= oldAwake || awake > n / BETA));
+
+            // switch back to top-down: the bitmap becomes the frontier list again
+            frontier.clear();
+            for (int v = 0; v < n; ++v) {
+                if (inFrontier[v]) {
+                    frontier.push_back(v);
+                }
+            }
+            scoutCount = 1;
+        } else {
+            // top-down step
+            edgesToCheck -= scoutCount;
+            scoutCount = 0;
+            ++level;
+            std::vector<int> next;
+            for (int u : frontier) {
+                for (int v : adjList[u]) {
+                    if (!data[v].visited) {
+                        data[v].visited = true;
+                        data[v].parent = u;
+                        data[v].distance = level;
+                        scoutCount += adjList[v].size();
+                        next.push_back(v);
+                    }
+                }
+            }
+            frontier.swap(next);
+        }
+    }
+    return data;
+}
+
+/*=================================================================================================
+Function: parallelBreadthFirstSearch
+Description:
+    Level-synchronous parallel BFS. Each level, threads grab chunks of the frontier and scan
+    their out-edges. A vertex is claimed by whichever thread first swaps its distance from
+    infinity to the next level (atomic compare-exchange), and the winner appends it to its own
+    next-frontier buffer, so no locks are needed. The buffers are concatenated to form the
+    next frontier.
+    The worker threads are a ThreadTeam, started at the first large frontier and kept for the
+    rest of the search. Between levels they sleep on a condition variable; team.run wakes them
+    and returns once they have all finished the level, which is the per-level barrier. Small
+    frontiers are processed on the calling thread alone, so a long chain of small levels (a
+    road network, a path) costs no thread start-ups or wake-ups.
+    In deterministic mode every thread that reaches a newly claimed vertex also records
+    (frontier position of u, index of the edge in u's list) with an atomic minimum. The
+    smallest key is exactly the edge a queue-based BFS would have used first, so sorting the
+    next frontier by key and taking parents from it reproduces breadthFirstSearch.
+Parameters:
+    - int s: the source vertex to start BFS from.
+    - int numThreads: number of threads, <= 0 for one per hardware thread.
+    - bool deterministic: reproduce breadthFirstSearch's parents exactly.
+Return:
+    - std::vector<TraversalData>: visited status, parent, and distance from s for each vertex.
+=================================================================================================*/
+std::vector<TraversalData> Graph::parallelBreadthFirstSearch(int s, int numThreads, bool deterministic) {
+    if (!vertexIn(s))
+    throw std::out_of_range("BFS: source not in graph");
+
+    const size_t CHUNK = 64; // frontier vertices taken per grab
+    const size_t MIN_PARALLEL_FRONTIER = 1024; // smaller frontiers are not worth waking threads for
+    const int INF = std::numeric_limits<int>::max();
+
+    int n = adjList.size();
+    numThreads = resolveThreadCount(numThreads);
+
+    std::vector<std::atomic<int> > distance(n);
+    std::vector<int> parent(n, -1);
+    std::vector<std::atomic<unsigned long long> > key(deterministic ? n : 0);
+    for (int i = 0; i < n; ++i) {
+        distance[i].store(INF, std::memory_order_relaxed);
+    }
+    // every vertex is claimed at most once, so its key only needs resetting here
+    for (size_t i = 0; i < key.size(); ++i) {
+        key[i].store(std::numeric_limits<unsigned long long>::max(), std::memory_order_relaxed);
+    }
+    distance[s].store(0, std::memory_order_relaxed);
+
+    std::vector<int> frontier(1, s);
+    std::vector<std::vector<int> > buffers(numThreads); // per-thread next frontier
+    std::atomic<size_t> cursor(0);
+    int level = 0;
+
+    // scan a share of the frontier's out-edges into buffers[t]
+    auto expand = [&](int t) {
+        std::vector<int> &next = buffers[t];
+        size_t begin;
+        while ((begin = cursor.fetch_add(CHUNK, std::memory_order_relaxed)) < frontier.size()) {
+            size_t end = std::min(begin + CHUNK, frontier.size());
+            for (size_t i = begin; i < end; ++i) {
+                int u = frontier[i];
+                const std::vector<int> &neighbors = adjList[u];
+                for (size_t j = 0; j < neighbors.size(); ++j) {
+                    int v = neighbors[j];
+                    int seen = distance[v].load(std::memory_order_relaxed);
+                    if (seen == INF) {
+                        // try to claim v for this level
+                        if (distance[v].compare_exchange_strong(seen, level + 1, std::memory_order_relaxed)) {
+                            next.push_back(v);
+                            if (!deterministic) {
+                                parent[v] = u;
+                            }
+                            seen = level + 1;
+                        }
+                    }
+                    if (deterministic && seen == level + 1) {
+                        // keep the smallest (frontier position, edge index) that reached v
+                        unsigned long long mine = (static_cast<unsigned long long>(i) << 32) | j;
+                        unsigned long long best = key[v].load(std::memory_order_relaxed);
+                        while (mine < best &&
+                               !key[v].compare_exchange_weak(best, mine, std::memory_order_relaxed)) {
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    // gather the per-thread buffers into the next frontier
+    auto advance = [&]() {
+        std::vector<int> next;
+        for (std::vector<int> &buffer : buffers) {
+            next.insert(next.end(), buffer.begin(), buffer.end());
+            buffer.clear();
+        }
+        if (deterministic) {
+            // queue order is the order of the winning keys
+            std::sort(next.begin(), next.end(), [&](int a, int b) {
+                return key[a].load(std::memory_order_relaxed) < key[b].load(std::memory_order_relaxed);
+            });
+            for (int v : next) {
+                parent[v] = frontier[key[v].load(std::memory_order_relaxed) >> 32];
+            }
+        }
+        frontier.swap(next);
+        ++level;
+    };
+
+    // the workers are started once for the whole search, and only if a frontier is large
+    ThreadTeam team(numThreads);
+    while (!frontier.empty()) {
+        cursor.store(0, std::memory_order_relaxed);
+        if (frontier.size() < MIN_PARALLEL_FRONTIER) {
+            expand(0);
+        } else {
+            team.run(expand);
+        }
+        advance();
+    }
+
+    std::vector<TraversalData> data(n);
+    for (int i = 0; i < n; ++i) {
+        data[i].distance = distance[i].load(std::memory_order_relaxed);
+        data[i].visited = data[i].distance != INF;
+        data[i].parent = parent[i];
+    }
+    return data;
+}
+
+/*=================================================================================================
+Function: breadthFirstSearchFields
+Description:
+    BFS that writes its results as separate arrays and only the ones selected by Fields: a
+    visited bitset (1 bit per vertex) if Visited is set, an int32 parent array if Parent is set,
+    and a DistanceT distance array if Distance is set. The search always keeps the bitset
+    internally and only hands it over when asked for. The search runs level by level with two
+    frontier vectors, so the current level is known without reading a distance array. A
+    distance-only query with uint8 distances moves 1 byte + 1 bit per vertex instead of a
+    20-byte TraversalData.
+Parameters:
+    - int s: the source vertex to start BFS from.
+Return:
+    - TraversalResult<Fields, DistanceT>: the selected outputs.
+=================================================================================================*/
+template <unsigned Fields, typename DistanceT>
+TraversalResult<Fields, DistanceT> Graph::breadthFirstSearchFields(int s) {
+    if (!vertexIn(s))
+    throw std::out_of_range("BFS: source not in graph");
+
+    const bool wantVisited = (Fields & TraversalFields::Visited) != 0;
+    const bool wantParent = (Fields & TraversalFields::Parent) != 0;
+    const bool wantDistance = (Fields & TraversalFields::Distance) != 0;
+    const DistanceT INF = std::numeric_limits<DistanceT>::max();
+
+    int n = adjList.size();
+    TraversalResult<Fields, DistanceT> result;
+    std::vector<std::uint64_t> visitedBits((n + 63) / 64, 0);
+    if (wantParent) {
+        result.parent.assign(n, -1);
+    }
+    if (wantDistance) {
+        result.distance.assign(n, INF);
+        result.distance[s] = 0;
+    }
+    visitedBits[s >> 6] |= std::uint64_t(1) << (s & 63);
+
+    std::vector<int> frontier(1, s);
+    std::vector<int> next;
+    long long level = 0;
+    while (!frontier.empty()) {
+        ++level;
+        for (int u : frontier) {
+            for (int v : adjList[u]) {
+                std::uint64_t &word = visitedBits[v >> 6];
+                std::uint64_t bit = std::uint64_t(1) << (v & 63);
+                if (!(word & bit)) {
+                    word |= bit;
+                    if (wantParent) {
+                        result.parent[v] = u;
+                    }
+                    if (wantDistance) {
+                        // compared unsigned so a 64-bit unsigned INF does not wrap to -1
+                        if (static_cast<unsigned long long>(level) >= static_cast<unsigned long long>(INF)) {
+                            throw std::overflow_error("BFS: distance does not fit in the distance type");
+                        }
+                        result.distance[v] = static_cast<DistanceT>(level);
+                    }
+                    next.push_back(v);
+                }
+            }
+        }
+        frontier.swap(next);
+        next.clear();
+    }
+    if (wantVisited) {
+        result.visitedBits.swap(visitedBits);
+    }
+    return result;
+}
+
+/*=================================================================================================
+Function: breadthFirstSearch (workspace)
+Description:
+    Same BFS as breadthFirstSearch(s), but the per-vertex data, visited marks and queue live in
+    a reusable workspace. Nothing is initialized up front: a vertex counts as unvisited until it
+    is stamped with the current run's epoch, so a query that reaches k vertices costs O(k + edges
+    scanned) instead of O(n).
+Parameters:
+    - int s: the source vertex to start BFS from.
+    - TraversalWorkspace& ws: where the results are written.
+Return:
+    - nothing
+=================================================================================================*/
+void Graph::breadthFirstSearch(int s, TraversalWorkspace &ws) {
+    if (!vertexIn(s))
+    throw std::out_of_range("BFS: source not in graph");
+
+    ws.start(adjList.size());
+    TraversalData &source = ws.visit(s);
+    source.parent = -1;
+    source.distance = 0;
+
+    // the list of reached vertices doubles as the BFS queue
+    for (size_t head = 0; head < ws.visitedList.size(); ++head) {
+        int u = ws.visitedList[head];
+        int next = ws.data[u].distance + 1;
+        for (int v : adjList[u]) {
+            if (!ws.seen(v)) {
+                TraversalData &d = ws.visit(v);
+                d.parent = u;
+                d.distance = next;
+            }
+        }
+    }
+}
+
+/*=================================================================================================
+Function: shortestPath
+Description:
+    Point-to-point shortest path without workspaces; see the workspace version below.
+Parameters:
+    - int s: the start vertex.
+    - int t: the target vertex.
+Return:
+    - PathResult: the distance and the path from s to t.
+=================================================================================================*/
+PathResult Graph::shortestPath(int s, int t) {
+    TraversalWorkspace forward, backward;
+    return shortestPath(s, t, forward, backward);
+}
+
+/*=================================================================================================
+Function: shortestPath (workspaces)
+Description:
+    Bidirectional BFS. One search goes forward from s over out-edges, the other backward from t
+    over in-edges, and each round the side with the smaller frontier expands one full level.
+    When a newly reached vertex has already been reached by the other side, the two searches
+    have met. The level is finished (a later vertex on it may give a shorter total) and the
+    best meeting point wins: no path can be shorter, since every vertex within the explored
+    radii had been labeled by only one side before this level. The path is the forward parent
+    chain from s to the meeting point followed by the backward parent chain to t.
+Parameters:
+    - int s: the start vertex.
+    - int t: the target vertex.
+    - TraversalWorkspace& forward, TraversalWorkspace& backward: scratch space for the two
+      searches (they hold the explored distances/parents afterwards).
+Return:
+    - PathResult: the distance and the path from s to t.
+=================================================================================================*/
+PathResult Graph::shortestPath(int s, int t, TraversalWorkspace &forward, TraversalWorkspace &backward) {
+    if (!vertexIn(s) || !vertexIn(t)) {
+        throw std::out_of_range("shortestPath: vertex index out of range");
+    }
+    const std::vector<std::vector<int> >& in = inEdges();
+
+    PathResult result;
+    result.distance = std::numeric_limits<int>::max();
+
+    forward.start(adjList.size());
+    backward.start(adjList.size());
+    forward.visit(s).parent = -1;
+    forward.data[s].distance = 0;
+    backward.visit(t).parent = -1;
+    backward.data[t].distance = 0;
+
+    int meet = -1;
+    if (s == t) {
+        meet = s;
+        result.distance = 0;
+    }
+
+    // each side's current frontier is the tail of its reached list starting at head
+    size_t forwardHead = 0, backwardHead = 0;
+    while (meet == -1 && forwardHead < forward.visitedList.size() && backwardHead < backward.visitedList.size()) {
+        bool goForward = forward.visitedList.size() - forwardHead <= backward.visitedList.size() - backwardHead;
+        TraversalWorkspace &mine = goForward ? forward : backward;
+        TraversalWorkspace &other = goForward ? backward : forward;
+        const std::vector<std::vector<int> >& edges = goForward ? adjList : in;
+        size_t &head = goForward ? forwardHead : backwardHead;
+
+        // expand exactly one level
+        size_t levelEnd = mine.visitedList.size();
+        for (; head < levelEnd; ++head) {
+            int u = mine.visitedList[head];
+            int next = mine.data[u].distance + 1;
+            for (int v : edges[u]) {
+                if (mine.seen(v)) {
+                    continue;
+                }
+                TraversalData &d = mine.visit(v);
+                d.parent = u;
+                d.distance = next;
+                if (other.seen(v) && next + other.data[v].distance < result.distance) {
+                    result.distance = next + other.data[v].distance;
+                    meet = v;
+                }
+            }
+        }
+    }
+
+    if (meet == -1) {
+        return result; // t is not reachable from s
+    }
+
+    // s ... meet from the forward parents, then meet ... t from the backward parents
+    for (int v = meet; v != -1; v = forward.data[v].parent) {
+        result.path.push_back(v);
+    }
+    std::reverse(result.path.begin(), result.path.end());
+    for (int v = backward.data[meet].parent; v != -1; v = backward.data[v].parent) {
+        result.path.push_back(v);
+    }
+    return result;
+}
+
+/*=================================================================================================
+Function: multiSourceBFS
+Description:
+    Bit-parallel multi-source BFS (MS-BFS, Then et al.). Sources are taken in batches of 64 and
+    each vertex keeps two 64-bit masks: seen (which searches have reached it) and visit (which
+    searches have it in their current frontier). One pass over the edges per level moves all
+    64 frontiers at once: for an edge (u, v), the searches in visit[u] that have not seen v yet
+    reach v on this level. Searches that overlap therefore share every adjacency scan.
+Parameters:
+    - const std::vector<int>& sources: the start vertices (repeats are allowed).
+Return:
+    - std::vector<std::vector<int>>: one distance array per source.
+=================================================================================================*/
+std::vector<std::vector<int> > Graph::multiSourceBFS(const std::vector<int> &sources) {
+    for (int s : sources) {
+        if (!vertexIn(s)) {
+            throw std::out_of_range("multiSourceBFS: source not in graph");
+        }
+    }
+
+    int n = adjList.size();
+    std::vector<std::vector<int> > distance(sources.size(), std::vector<int>(n, std::numeric_limits<int>::max()));
+
+    std::vector<std::uint64_t> seen(n), visit(n), visitNext(n);
+    for (size_t batch = 0; batch < sources.size(); batch += 64) {
+        size_t count = std::min<size_t>(64, sources.size() - batch);
+        std::fill(seen.begin(), seen.end(), 0);
+        std::fill(visit.begin(), visit.end(), 0);
+
+        // bit i of a mask stands for the search from sources[batch + i]
+        for (size_t i = 0; i < count; ++i) {
+            int s = sources[batch + i];
+            seen[s] |= std::uint64_t(1) << i;
+            visit[s] |= std::uint64_t(1) << i;
+            distance[batch + i][s] = 0;
+        }
+
+        bool active = true;
+        for (int level = 1; active; ++level) {
+            // push every frontier one step along the edges
+            for (int u = 0; u < n; ++u) {
+                if (visit[u] == 0) {
+                    continue;
+                }
+                for (int v : adjList[u]) {
+                    visitNext[v] |= visit[u] & ~seen[v];
+                }
+            }
+
+            // record the searches that reached each vertex for the first time
+            active = false;
+            for (int v = 0; v < n; ++v) {
+                std::uint64_t reached = visitNext[v] & ~seen[v];
+                visitNext[v] = 0;
+                visit[v] = reached;
+                if (reached == 0) {
+                    continue;
+                }
+                active = true;
+                seen[v] |= reached;
+                while (reached) {
+                    int i = __builtin_ctzll(reached); // lowest set bit
+                    distance[batch + i][v] = level;
+                    reached &= reached - 1;
+                }
+            }
+        }
+    }
+    return distance;
+}
+
 /*=================================================================================================
 Function: depthFirstSearch
 Description:
@@ -244,12 +1047,13 @@ std::vector<TraversalData> Graph::depthFirstSearch() {
 
     int time = 0; // Global time counter for discovery/finish times
     int order = n; // Used for topological ordering (counting down)
+    std::vector<std::pair<int, size_t> > stack; // shared by all dfsVisit calls
 
     // Traverse each vertex in numerical order
     for (int u = 0; u < n; ++u) {
         // If vertex u hasn't been visited yet, run DFS from it
         if (!data[u].visited) {
-            dfsVisit(data, time, u, order);
+            dfsVisit(data, time, u, order, stack);
         }
     }
     // Return traversal data for all vertices
@@ -257,53 +1061,2130 @@ std::vector<TraversalData> Graph::depthFirstSearch() {
 }
 
 /*=================================================================================================
-Function: dfsVisit
+Function: depthFirstSearch (workspace)
 Description:
-    A recursive helper function for DFS that visits all reachable vertices from
-    the starting vertex u. Sets the discovery and finish times, parent, and order
-    for each visited vertex.
+    DFS restricted to the vertices reachable from s, using the same explicit-stack walk as
+    dfsVisit but with the workspace's epoch-stamped visited marks, so the cost is proportional to
+    what is reached. Orders are counted down from n during the walk and shifted to 1...k at the
+    end, once the number of reached vertices k is known.
+Parameters:
+    - int s: the source vertex to start DFS from.
+    - TraversalWorkspace& ws: where the results are written.
+Return:
+    - nothing
+=================================================================================================*/
+void Graph::depthFirstSearch(int s, TraversalWorkspace &ws) {
+    if (!vertexIn(s))
+    throw std::out_of_range("DFS: source not in graph");
+
+    int n = adjList.size();
+    ws.start(n);
+    int time = 0;
+    int order = n;
+
+    TraversalData &source = ws.visit(s);
+    source.parent = -1;
+    source.discovery = ++time;
+    ws.stack.push_back(std::make_pair(s, 0));
+
+    while (!ws.stack.empty()) {
+        int x = ws.stack.back().first;
+        size_t &next = ws.stack.back().second;
+        const std::vector<int> &neighbors = adjList[x];
+
+        // Skip neighbors that were already visited
+        while (next < neighbors.size() && ws.seen(neighbors[next])) {
+            ++next;
+        }
+
+        if (next < neighbors.size()) {
+            int v = neighbors[next++];
+            TraversalData &d = ws.visit(v);
+            d.parent = x;
+            d.discovery = ++time;
+            ws.stack.push_back(std::make_pair(v, 0));
+        } else {
+            ws.data[x].finish = ++time;
+            ws.data[x].order = order--;
+            ws.stack.pop_back();
+        }
+    }
+
+    // orders were handed out as n, n-1, ...; shift them down to k, k-1, ..., 1
+    int shift = n - ws.visitedList.size();
+    for (int v : ws.visitedList) {
+        ws.data[v].order -= shift;
+    }
+}
+
+/*=================================================================================================
+Function: topologicalSort
+Description:
+    Turns the order labels computed by depthFirstSearch into the actual sequence of vertices.
+    A DFS assigns order labels to any graph, so every edge is checked to go forward in the
+    sequence; one that goes backward means there is a cycle.
+Parameters:
+    - none
+Return:
+    - std::vector<int>: the vertices in topological order.
+=================================================================================================*/
+std::vector<int> Graph::topologicalSort() {
+    std::vector<TraversalData> data = depthFirstSearch();
+    int n = adjList.size();
+
+    std::vector<int> sequence(n);
+    for (int v = 0; v < n; ++v) {
+        sequence[data[v].order - 1] = v;
+    }
+
+    for (int u = 0; u < n; ++u) {
+        for (int v : adjList[u]) {
+            if (data[v].order <= data[u].order) {
+                throw std::invalid_argument("topologicalSort: graph has a cycle");
+            }
+        }
+    }
+    return sequence;
+}
+
+/*=================================================================================================
+Function: topologicalLevels
+Description:
+    Parallel Kahn's algorithm. In-degrees are counted with atomic increments, then the graph is
+    peeled one level at a time: threads take chunks of the current level and decrement the
+    in-degree of each out-neighbor; whichever thread brings a neighbor to zero appends it to
+    its own buffer for the next level. Buffers are merged and sorted so the output does not
+    depend on thread timing. Small levels run on the calling thread only; the others are
+    handed to one ThreadTeam, so a deep DAG does not start threads for every level.
+Parameters:
+    - int numThreads: number of threads, <= 0 for one per hardware thread.
+    - ThreadTeam& team: the threads to use (the overload for callers that already have one).
+Return:
+    - std::vector<std::vector<int>>: the dependency levels (wavefronts).
+=================================================================================================*/
+std::vector<std::vector<int> > Graph::topologicalLevels(int numThreads) const {
+    ThreadTeam team(numThreads);
+    return topologicalLevels(team);
+}
+
+std::vector<std::vector<int> > Graph::topologicalLevels(ThreadTeam &team) const {
+    const size_t CHUNK = 64; // vertices taken per grab
+    const size_t MIN_PARALLEL = 1024; // smaller levels are not worth waking threads for
+
+    int n = adjList.size();
+    int numThreads = team.size();
+    std::vector<std::atomic<int> > inDegree(n);
+    for (int v = 0; v < n; ++v) {
+        inDegree[v].store(0, std::memory_order_relaxed);
+    }
+
+    // count in-degrees, each thread taking a contiguous block of sources
+    auto count = [&](int t, int threads) {
+        int begin = static_cast<long long>(n) * t / threads;
+        int end = static_cast<long long>(n) * (t + 1) / threads;
+        for (int u = begin; u < end; ++u) {
+            for (int v : adjList[u]) {
+                inDegree[v].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    };
+    if (static_cast<size_t>(n) < MIN_PARALLEL) {
+        count(0, 1);
+    } else {
+        team.run([&](int t) { count(t, numThreads); });
+    }
+
+    std::vector<std::vector<int> > levels;
+    std::vector<int> current;
+    for (int v = 0; v < n; ++v) {
+        if (inDegree[v].load(std::memory_order_relaxed) == 0) {
+            current.push_back(v);
+        }
+    }
+
+    int placed = 0;
+    std::vector<std::vector<int> > buffers(numThreads); // per-thread next level
+    std::atomic<size_t> cursor(0);
+    auto release = [&](int t) {
+        size_t begin;
+        while ((begin = cursor.fetch_add(CHUNK, std::memory_order_relaxed)) < current.size()) {
+            size_t end = std::min(begin + CHUNK, current.size());
+            for (size_t i = begin; i < end; ++i) {
+                for (int v : adjList[current[i]]) {
+                    // the last predecessor to finish releases v
+                    if (inDegree[v].fetch_sub(1, std::memory_order_relaxed) == 1) {
+                        buffers[t].push_back(v);
+                    }
+                }
+            }
+        }
+    };
+    while (!current.empty()) {
+        placed += current.size();
+        cursor.store(0, std::memory_order_relaxed);
+        if (current.size() < MIN_PARALLEL) {
+            release(0);
+        } else {
+            team.run(release);
+        }
+
+        std::vector<int> next;
+        for (std::vector<int> &buffer : buffers) {
+            next.insert(next.end(), buffer.begin(), buffer.end());
+            buffer.clear();
+        }
+        std::sort(next.begin(), next.end());
+
+        levels.push_back(std::vector<int>());
+        levels.back().swap(current);
+        current.swap(next);
+    }
+
+    // vertices on a cycle never reach in-degree zero
+    if (placed != n) {
+        throw std::invalid_argument("topologicalLevels: graph has a cycle");
+    }
+    return levels;
+}
+
+/*=================================================================================================
+Function: enableTopologicalOrder
+Description:
+    Starts maintaining a topological order, seeded from topologicalSort.
+Parameters:
+    - none
+Return:
+    - nothing
+=================================================================================================*/
+void Graph::enableTopologicalOrder() {
+    topoVertex = topologicalSort(); // throws if there is a cycle
+    int n = adjList.size();
+    topoPosition.assign(n, 0);
+    for (int i = 0; i < n; ++i) {
+        topoPosition[topoVertex[i]] = i;
+    }
+    topoMark.assign(n, 0);
+    topoEnabled = true;
+}
+
+/*=================================================================================================
+Function: disableTopologicalOrder
+Description:
+    Stops maintaining the topological order and releases its memory.
+Parameters:
+    - none
+Return:
+    - nothing
+=================================================================================================*/
+void Graph::disableTopologicalOrder() {
+    topoEnabled = false;
+    std::vector<int>().swap(topoPosition);
+    std::vector<int>().swap(topoVertex);
+    std::vector<char>().swap(topoMark);
+}
+
+/*=================================================================================================
+Function: topologicalOrder
+Description:
+    The maintained topological order.
+Parameters:
+    - none
+Return:
+    - const std::vector<int>&: the vertices in topological order.
+=================================================================================================*/
+const std::vector<int>& Graph::topologicalOrder() const {
+    if (!topoEnabled) {
+        throw std::logic_error("topologicalOrder: call enableTopologicalOrder first");
+    }
+    return topoVertex;
+}
+
+/*=================================================================================================
+Function: reorderForEdge
+Description:
+    Pearce-Kelly dynamic topological sort. The new edge (u, v) breaks the order only when u sits
+    at or after v, and then only vertices between their positions can be affected:
+      - a forward search from v over out-edges, limited to positions <= pos(u), finds deltaF;
+        if it reaches u the edge would close a cycle
+      - a backward search from u over in-edges, limited to positions >= pos(v), finds deltaB
+    The positions held by deltaB and deltaF are pooled and handed out again, deltaB first and
+    deltaF after, each keeping its internal relative order. Everything else stays put, so the
+    cost depends on the affected region rather than on the whole graph.
+Parameters:
+    - int u: the source of the new edge.
+    - int v: the target of the new edge.
+Return:
+    - nothing
+=================================================================================================*/
+void Graph::reorderForEdge(int u, int v) {
+    if (u == v) {
+        throw std::invalid_argument("addEdge: edge would create a cycle"); // self-loop
+    }
+    const std::vector<std::vector<int> >& in = inEdges();
+    int lower = topoPosition[v];
+    int upper = topoPosition[u];
+
+    std::vector<int> deltaF, deltaB, stack;
+
+    // forward from v, staying at or before u's position
+    topoMark[v] = 1;
+    deltaF.push_back(v);
+    stack.push_back(v);
+    while (!stack.empty()) {
+        int x = stack.back();
+        stack.pop_back();
+        for (int w : adjList[x]) {
+            if (w == u) {
+                // v reaches u: clear the marks and refuse the edge
+                for (int y : deltaF) {
+                    topoMark[y] = 0;
+                }
+                throw std::invalid_argument("addEdge: edge would create a cycle");
+            }
+            if (!topoMark[w] && topoPosition[w] <= upper) {
+                topoMark[w] = 1;
+                deltaF.push_back(w);
+                stack.push_back(w);
+            }
+        }
+    }
+
+    // backward from u, staying at or after v's position
+    topoMark[u] = 1;
+    deltaB.push_back(u);
+    stack.push_back(u);
+    while (!stack.empty()) {
+        int x = stack.back();
+        stack.pop_back();
+        for (int w : in[x]) {
+            if (!topoMark[w] && topoPosition[w] >= lower) {
+                topoMark[w] = 1;
+                deltaB.push_back(w);
+                stack.push_back(w);
+            }
+        }
+    }
+
+    // keep each set's internal order
+    auto byPosition = [&](int a, int b) { return topoPosition[a] < topoPosition[b]; };
+    std::sort(deltaB.begin(), deltaB.end(), byPosition);
+    std::sort(deltaF.begin(), deltaF.end(), byPosition);
+
+    // pool the positions and hand them out: deltaB first, then deltaF
+    std::vector<int> moved(deltaB);
+    moved.insert(moved.end(), deltaF.begin(), deltaF.end());
+    std::vector<int> slots;
+    for (int x : moved) {
+        slots.push_back(topoPosition[x]);
+        topoMark[x] = 0;
+    }
+    std::sort(slots.begin(), slots.end());
+    for (size_t i = 0; i < moved.size(); ++i) {
+        topoPosition[moved[i]] = slots[i];
+        topoVertex[slots[i]] = moved[i];
+    }
+}
+
+/*=================================================================================================
+Function: dfsVisit
+Description:
+    Visits all vertices reachable from the starting vertex u, setting the discovery and finish
+    times, parent, and order for each of them. Instead of recursing, it keeps an explicit stack
+    of (vertex, index of the next neighbor to look at), which is exactly what the recursive
+    version keeps in its call frames, so the results are identical but long paths cannot
+    overflow the call stack.
 Parameters:
     - std::vector<TraversalData>& data: the traversal data to populate.
     - int& time: a reference to the global DFS time counter.
     - int u: the current vertex being visited.
     - int& order: a reference to the current topological order label.
+    - std::vector<std::pair<int, size_t>>& stack: scratch stack, empty on entry and on return.
 Return:
     - nothing 
 =================================================================================================*/
-void Graph::dfsVisit(std::vector<TraversalData> &data, int &time, int u, int &order) {
+void Graph::dfsVisit(std::vector<TraversalData> &data, int &time, int u, int &order,
+                     std::vector<std::pair<int, size_t> > &stack) {
     data[u].visited = true; // Mark u as visited
     data[u].discovery = ++time; // Record discovery time 
+    stack.push_back(std::make_pair(u, 0));
 
-    // Visit all neighbors of u
-    for (int v : adjList[u]) {
-        if (!data[v].visited) {  // If neighbor v hasn't been visited
-            data[v].parent = u; // Set u as v's parent
-            dfsVisit(data, time, v, order);  // Recursively visit v
+    while (!stack.empty()) {
+        int x = stack.back().first;
+        size_t &next = stack.back().second;
+        const std::vector<int> &neighbors = adjList[x];
+
+        // Skip neighbors that were already visited
+        while (next < neighbors.size() && data[neighbors[next]].visited) {
+            ++next;
+        }
+
+        if (next < neighbors.size()) {
+            // Descend into the first unvisited neighbor v
+            int v = neighbors[next++];
+            data[v].visited = true;
+            data[v].parent = x; // Set x as v's parent
+            data[v].discovery = ++time;
+            stack.push_back(std::make_pair(v, 0)); // invalidates next, which is not used again
+        } else {
+            data[x].finish = ++time; // Record finish time after all children are visited
+            data[x].order = order--;  // Assign topological order, then decrement
+            stack.pop_back();
         }
     }
+}
+
+/*=================================================================================================
+Constructor: TraversalWorkspace
+Description:
+    Creates an empty workspace. Its arrays are sized by the first traversal that uses it.
+=================================================================================================*/
+TraversalWorkspace::TraversalWorkspace() {}
 
-    data[u].finish = ++time; // Record finish time after all children are visited
-    data[u].order = order--;  // Assign topological order, then decrement
+/*=================================================================================================
+Function: TraversalWorkspace::start
+Description:
+    Begins a new run by moving to the next epoch, which invalidates all previous results in
+    O(1). The arrays are only (re)initialized when the graph size changes or, once every 2^32
+    runs, when the epoch counter wraps around.
+Parameters:
+    - int n: number of vertices of the graph being traversed.
+Return:
+    - nothing
+=================================================================================================*/
+void TraversalWorkspace::start(int n) {
+    if (static_cast<int>(data.size()) != n) {
+        data.assign(n, TraversalData());
+        stamp.assign(n, 0);
+        epoch = 0;
+    }
+    ++epoch;
+    if (epoch == 0) {
+        // wrapped around: old stamps could now look current, so clear them
+        std::fill(stamp.begin(), stamp.end(), 0);
+        epoch = 1;
+    }
+    visitedList.clear();
+    stack.clear();
 }
 
 /*=================================================================================================
-Function: readFromSTDIN
+Function: TraversalWorkspace::seen / visit
 Description:
-    Constructs a graph based on data read from a txt file 
+    seen checks whether v has been reached in the current run; visit stamps v as reached,
+    records it in the reached list and returns its entry for the caller to fill in.
+Parameters:
+    - int v: the vertex.
 Return:
-    - Graph: a graph object constructed from the input data.
+    - bool / TraversalData&
 =================================================================================================*/
-Graph Graph::readFromSTDIN() {
-    // for readinf in the txt file 
-    int n, m;
-    std::cin >> n >> m;
-    Graph g(n);
-    for (int i = 0; i < m; ++i) {
-        int u, v;
-        std::cin >> u >> v;
-        std::cout << "Reading edge: " << u << " -> " << v << std::endl;
-        g.addEdge(u, v);
+bool TraversalWorkspace::seen(int v) const {
+    return stamp[v] == epoch;
+}
+
+TraversalData& TraversalWorkspace::visit(int v) {
+    stamp[v] = epoch;
+    visitedList.push_back(v);
+    data[v].visited = true;
+    return data[v];
+}
+
+/*=================================================================================================
+Function: TraversalWorkspace::visited
+Description:
+    Checks whether v was reached by the last traversal run in this workspace.
+Parameters:
+    - int v: the vertex.
+Return:
+    - bool: true if v was reached.
+=================================================================================================*/
+bool TraversalWorkspace::visited(int v) const {
+    if (v < 0 || v >= static_cast<int>(data.size())) {
+        throw std::out_of_range("TraversalWorkspace: vertex index out of range");
     }
-    return g;
+    return seen(v);
+}
+
+/*=================================================================================================
+Function: TraversalWorkspace::get
+Description:
+    Returns the traversal data of v from the last run. Vertices the run did not reach get the
+    same values a fresh breadthFirstSearch would give them.
+Parameters:
+    - int v: the vertex.
+Return:
+    - TraversalData: a copy of v's data.
+=================================================================================================*/
+TraversalData TraversalWorkspace::get(int v) const {
+    if (!visited(v)) {
+        TraversalData unreached;
+        unreached.visited = false;
+        unreached.parent = -1;
+        unreached.distance = std::numeric_limits<int>::max();
+        return unreached;
+    }
+    return data[v];
+}
+
+/*=================================================================================================
+Function: TraversalWorkspace::reached
+Description:
+    The vertices reached by the last run, in the order they were reached (BFS order or DFS
+    discovery order).
+Return:
+    - const std::vector<int>&: the reached vertices.
+=================================================================================================*/
+const std::vector<int>& TraversalWorkspace::reached() const {
+    return visitedList;
+}
+
+/*=================================================================================================
+Function: stronglyConnectedComponents
+Description:
+    Tarjan's algorithm driven by the same kind of explicit (vertex, next neighbor) stack as
+    dfsVisit, so it works on arbitrarily deep graphs. Each vertex gets a DFS index and a
+    low-link (smallest index reachable through its DFS subtree plus one back edge to a vertex
+    still on the component stack). A vertex whose low-link equals its own index is the root of
+    a component, and the component is everything above it on the component stack.
+Parameters:
+    - none
+Return:
+    - ComponentResult: component id of each vertex, component sizes and count.
+=================================================================================================*/
+ComponentResult Graph::stronglyConnectedComponents() const {
+    int n = adjList.size();
+    ComponentResult result;
+    result.component.assign(n, -1);
+    result.count = 0;
+
+    std::vector<int> index(n, -1), low(n, 0);
+    std::vector<char> onStack(n, 0);
+    std::vector<int> componentStack;
+    std::vector<std::pair<int, size_t> > stack;
+    int counter = 0;
+
+    for (int root = 0; root < n; ++root) {
+        if (index[root] != -1) {
+            continue;
+        }
+        index[root] = low[root] = counter++;
+        componentStack.push_back(root);
+        onStack[root] = 1;
+        stack.push_back(std::make_pair(root, 0));
+
+        while (!stack.empty()) {
+            int x = stack.back().first;
+            size_t &next = stack.back().second;
+
+            if (next < adjList[x].size()) {
+                int w = adjList[x][next++];
+                if (index[w] == -1) {
+                    // tree edge: descend
+                    index[w] = low[w] = counter++;
+                    componentStack.push_back(w);
+                    onStack[w] = 1;
+                    stack.push_back(std::make_pair(w, 0));
+                } else if (onStack[w]) {
+                    // edge back into the current component candidate
+                    low[x] = std::min(low[x], index[w]);
+                }
+                continue;
+            }
+
+            // x is finished
+            stack.pop_back();
+            if (low[x] == index[x]) {
+                int size = 0;
+                int w;
+                do {
+                    w = componentStack.back();
+                    componentStack.pop_back();
+                    onStack[w] = 0;
+                    result.component[w] = result.count;
+                    ++size;
+                } while (w != x);
+                result.sizes.push_back(size);
+                ++result.count;
+            }
+            if (!stack.empty()) {
+                int parent = stack.back().first;
+                low[parent] = std::min(low[parent], low[x]);
+            }
+        }
+    }
+    return result;
+}
+
+/*=================================================================================================
+Function: parallelStronglyConnectedComponents
+Description:
+    Forward-backward (FW-BW) decomposition with trimming.
+    Trim: a vertex with no in-edges or no out-edges from the remaining vertices is a component
+    on its own; removing it can expose more such vertices, so this repeats in rounds. Each
+    round's removed vertices are split across the threads, which decrement their neighbors'
+    degree counters atomically; a vertex whose counter reaches 0 is claimed by exactly one
+    thread (atomic exchange on its removed flag) for the next round. On real graphs this
+    removes most of the small components cheaply. A long chain takes one round per vertex, so
+    the rounds are handed to one ThreadTeam, which also runs the FW-BW workers, rather than
+    starting threads per round.
+    FW-BW: the remaining vertices form one task. A task picks a pivot and finds the vertices it
+    reaches (FW) and that reach it (BW), both searches staying inside the task. FW and BW
+    intersect in exactly the pivot's component. No other component can straddle the three
+    leftover sets FW\BW, BW\FW and the rest, so each becomes an independent task. Tasks are
+    shared by the worker threads through a queue; each task's vertices carry a unique color
+    so concurrent tasks never touch each other's vertices. Idle workers sleep on a condition
+    variable until a task is queued or the last task finishes.
+Parameters:
+    - int numThreads: number of threads, <= 0 for one per hardware thread.
+Return:
+    - ComponentResult: component id of each vertex, component sizes and count.
+=================================================================================================*/
+ComponentResult Graph::parallelStronglyConnectedComponents(int numThreads) {
+    int n = adjList.size();
+    numThreads = resolveThreadCount(numThreads);
+    const std::vector<std::vector<int> >& in = inEdges();
+
+    std::vector<int> label(n, -1); // raw component id, renumbered at the end
+    std::atomic<int> nextLabel(0);
+
+    // trim vertices with no remaining in- or out-edges
+    const size_t CHUNK = 64; // vertices taken per grab
+    const size_t MIN_PARALLEL = 1024; // smaller rounds are not worth waking threads for
+    std::vector<std::atomic<int> > inDegree(n), outDegree(n);
+    std::vector<std::atomic<char> > removed(n);
+    std::vector<std::vector<int> > buffers(numThreads); // per-thread next round
+    ThreadTeam team(numThreads);
+    auto start = [&](int t, int threads) {
+        int begin = static_cast<long long>(n) * t / threads;
+        int end = static_cast<long long>(n) * (t + 1) / threads;
+        for (int v = begin; v < end; ++v) {
+            inDegree[v].store(in[v].size(), std::memory_order_relaxed);
+            outDegree[v].store(adjList[v].size(), std::memory_order_relaxed);
+            bool isolated = in[v].empty() || adjList[v].empty();
+            removed[v].store(isolated, std::memory_order_relaxed);
+            if (isolated) {
+                label[v] = nextLabel++;
+                buffers[t].push_back(v);
+            }
+        }
+    };
+    if (static_cast<size_t>(n) < MIN_PARALLEL) {
+        start(0, 1);
+    } else {
+        team.run([&](int t) { start(t, numThreads); });
+    }
+
+    std::vector<int> current;
+    for (std::vector<int> &buffer : buffers) {
+        current.insert(current.end(), buffer.begin(), buffer.end());
+        buffer.clear();
+    }
+    std::atomic<size_t> cursor(0);
+    auto trim = [&](int t) {
+        // w lost its last remaining in- or out-edge; the first thread to notice removes it
+        auto release = [&](int w) {
+            if (removed[w].exchange(1, std::memory_order_relaxed) == 0) {
+                label[w] = nextLabel++;
+                buffers[t].push_back(w);
+            }
+        };
+        size_t begin;
+        while ((begin = cursor.fetch_add(CHUNK, std::memory_order_relaxed)) < current.size()) {
+            size_t end = std::min(begin + CHUNK, current.size());
+            for (size_t i = begin; i < end; ++i) {
+                int v = current[i];
+                for (int w : adjList[v]) {
+                    if (inDegree[w].fetch_sub(1, std::memory_order_relaxed) == 1) {
+                        release(w);
+                    }
+                }
+                for (int w : in[v]) {
+                    if (outDegree[w].fetch_sub(1, std::memory_order_relaxed) == 1) {
+                        release(w);
+                    }
+                }
+            }
+        }
+    };
+    while (!current.empty()) {
+        cursor.store(0, std::memory_order_relaxed);
+        if (current.size() < MIN_PARALLEL) {
+            trim(0);
+        } else {
+            team.run(trim);
+        }
+        current.clear();
+        for (std::vector<int> &buffer : buffers) {
+            current.insert(current.end(), buffer.begin(), buffer.end());
+            buffer.clear();
+        }
+    }
+
+    // color[v] is the task that owns v; -1 once v has its component
+    std::vector<std::atomic<int> > color(n);
+    std::vector<int> initial;
+    for (int v = 0; v < n; ++v) {
+        color[v].store(label[v] == -1 ? 0 : -1, std::memory_order_relaxed);
+        if (label[v] == -1) {
+            initial.push_back(v);
+        }
+    }
+    std::vector<char> forward(n, 0), backward(n, 0); // only written by the task owning the vertex
+
+    std::mutex queueLock;
+    std::condition_variable queueChanged; // a task was queued or the last task finished
+    std::deque<std::pair<int, std::vector<int> > > tasks; // (color, vertices)
+    int active = 0; // tasks queued or being processed, guarded by queueLock
+    std::atomic<int> nextColor(1);
+    if (!initial.empty()) {
+        tasks.push_back(std::make_pair(0, initial));
+        active = 1;
+    }
+
+    team.run([&](int) {
+        std::vector<int> stack;
+        while (true) {
+            std::pair<int, std::vector<int> > task;
+            {
+                std::unique_lock<std::mutex> guard(queueLock);
+                queueChanged.wait(guard, [&]() { return !tasks.empty() || active == 0; });
+                if (tasks.empty()) {
+                    return; // no task queued or running, so none will appear
+                }
+                task.first = tasks.front().first;
+                task.second.swap(tasks.front().second);
+                tasks.pop_front();
+            }
+
+            int c = task.first;
+            const std::vector<int> &vertices = task.second;
+            int pivot = vertices[0];
+
+            // search from the pivot inside color c, marking mark[] (forward or backward)
+            auto search = [&](const std::vector<std::vector<int> > &edges, std::vector<char> &mark) {
+                mark[pivot] = 1;
+                stack.push_back(pivot);
+                while (!stack.empty()) {
+                    int x = stack.back();
+                    stack.pop_back();
+                    for (int w : edges[x]) {
+                        if (color[w].load(std::memory_order_relaxed) == c && !mark[w]) {
+                            mark[w] = 1;
+                            stack.push_back(w);
+                        }
+                    }
+                }
+            };
+            search(adjList, forward);
+            search(in, backward);
+
+            // split into the pivot's component and the three leftover sets
+            int component = nextLabel++;
+            std::vector<int> parts[3];
+            for (int v : vertices) {
+                if (forward[v] && backward[v]) {
+                    label[v] = component;
+                } else {
+                    parts[forward[v] ? 0 : (backward[v] ? 1 : 2)].push_back(v);
+                }
+            }
+            for (int v : vertices) {
+                if (forward[v] && backward[v]) {
+                    color[v].store(-1, std::memory_order_relaxed);
+                }
+                forward[v] = backward[v] = 0;
+            }
+
+            for (std::vector<int> &part : parts) {
+                if (part.empty()) {
+                    continue;
+                }
+                if (part.size() == 1) {
+                    label[part[0]] = nextLabel++;
+                    color[part[0]].store(-1, std::memory_order_relaxed);
+                    continue;
+                }
+                int partColor = nextColor++;
+                for (int v : part) {
+                    color[v].store(partColor, std::memory_order_relaxed);
+                }
+                {
+                    std::lock_guard<std::mutex> guard(queueLock);
+                    ++active;
+                    tasks.push_back(std::make_pair(partColor, std::vector<int>()));
+                    tasks.back().second.swap(part);
+                }
+                queueChanged.notify_one();
+            }
+
+            bool finished;
+            {
+                std::lock_guard<std::mutex> guard(queueLock);
+                finished = --active == 0;
+            }
+            if (finished) {
+                queueChanged.notify_all(); // wake everyone to exit
+            }
+        }
+    });
+
+    // renumber the components in order of their smallest vertex
+    ComponentResult result;
+    result.component.assign(n, -1);
+    result.count = 0;
+    std::vector<int> renumber(nextLabel.load(), -1);
+    for (int v = 0; v < n; ++v) {
+        int &id = renumber[label[v]];
+        if (id == -1) {
+            id = result.count++;
+            result.sizes.push_back(0);
+        }
+        result.component[v] = id;
+        ++result.sizes[id];
+    }
+    return result;
+}
+
+/*=================================================================================================
+Function: weaklyConnectedComponents
+Description:
+    Afforest (Sutton, Ben-Nun, Barak) on a lock-free union-find. parent[v] points towards the
+    root of v's tree; link() joins two trees by swinging the larger root under the smaller one
+    with a compare-exchange, retrying if another thread got there first, so every root is the
+    smallest vertex of its tree.
+      1. Sampling: link each vertex to its first NEIGHBOR_ROUNDS out-neighbors and flatten the
+         trees. This is usually enough to build most of the giant component.
+      2. Estimate the largest component from SAMPLES random vertices.
+      3. Finish: every vertex outside that component links its remaining out-neighbors and all
+         of its in-neighbors. Vertices inside it are skipped entirely; an edge from such a
+         vertex to one outside is still seen through the outside vertex's in-edges.
+    Each phase splits the vertices across the threads in contiguous blocks.
+Parameters:
+    - int numThreads: number of threads, <= 0 for one per hardware thread.
+Return:
+    - ComponentResult: component id of each vertex, component sizes and count.
+=================================================================================================*/
+ComponentResult Graph::weaklyConnectedComponents(int numThreads) {
+    const int NEIGHBOR_ROUNDS = 2;
+    const int SAMPLES = 1024;
+
+    int n = adjList.size();
+    numThreads = resolveThreadCount(numThreads);
+    const std::vector<std::vector<int> >& in = inEdges();
+
+    std::vector<std::atomic<int> > parent(n);
+    for (int v = 0; v < n; ++v) {
+        parent[v].store(v, std::memory_order_relaxed);
+    }
+
+    // join the trees of u and v, hooking the larger root under the smaller
+    auto link = [&](int u, int v) {
+        int p1 = parent[u].load(std::memory_order_relaxed);
+        int p2 = parent[v].load(std::memory_order_relaxed);
+        while (p1 != p2) {
+            int high = std::max(p1, p2);
+            int low = std::min(p1, p2);
+            int highParent = parent[high].load(std::memory_order_relaxed);
+            if (highParent == low) {
+                break; // already joined
+            }
+            if (highParent == high &&
+                parent[high].compare_exchange_strong(highParent, low, std::memory_order_relaxed)) {
+                break; // high was a root and now hangs under low
+            }
+            // someone else moved high's root, walk up and retry
+            p1 = parent[parent[high].load(std::memory_order_relaxed)].load(std::memory_order_relaxed);
+            p2 = parent[low].load(std::memory_order_relaxed);
+        }
+    };
+
+    // point every vertex straight at its root
+    auto compress = [&](int t) {
+        int begin = static_cast<long long>(n) * t / numThreads;
+        int end = static_cast<long long>(n) * (t + 1) / numThreads;
+        for (int v = begin; v < end; ++v) {
+            int p = parent[v].load(std::memory_order_relaxed);
+            int pp;
+            while (p != (pp = parent[p].load(std::memory_order_relaxed))) {
+                parent[v].store(pp, std::memory_order_relaxed);
+                p = pp;
+            }
+        }
+    };
+
+    // 1. sample the first few out-neighbors of every vertex
+    for (int round = 0; round < NEIGHBOR_ROUNDS; ++round) {
+        runOnThreads(numThreads, [&](int t) {
+            int begin = static_cast<long long>(n) * t / numThreads;
+            int end = static_cast<long long>(n) * (t + 1) / numThreads;
+            for (int u = begin; u < end; ++u) {
+                if (round < static_cast<int>(adjList[u].size())) {
+                    link(u, adjList[u][round]);
+                }
+            }
+        });
+        runOnThreads(numThreads, compress);
+    }
+
+    // 2. guess the largest component from a random sample
+    int largest = -1;
+    if (n > 0) {
+        std::mt19937 random(27491095);
+        std::uniform_int_distribution<int> pick(0, n - 1);
+        std::vector<std::pair<int, int> > counts; // (root, hits), few distinct roots expected
+        int bestHits = 0;
+        for (int i = 0; i < SAMPLES; ++i) {
+            int root = parent[pick(random)].load(std::memory_order_relaxed);
+            size_t j = 0;
+            while (j < counts.size() && counts[j].first != root) {
+                ++j;
+            }
+            if (j == counts.size()) {
+                counts.push_back(std::make_pair(root, 0));
+            }
+            if (++counts[j].second > bestHits) {
+                bestHits = counts[j].second;
+                largest = root;
+            }
+        }
+    }
+
+    // 3. finish every vertex outside the largest component
+    runOnThreads(numThreads, [&](int t) {
+        int begin = static_cast<long long>(n) * t / numThreads;
+        int end = static_cast<long long>(n) * (t + 1) / numThreads;
+        for (int u = begin; u < end; ++u) {
+            if (parent[u].load(std::memory_order_relaxed) == largest) {
+                continue;
+            }
+            for (size_t i = NEIGHBOR_ROUNDS; i < adjList[u].size(); ++i) {
+                link(u, adjList[u][i]);
+            }
+            for (int w : in[u]) {
+                link(u, w);
+            }
+        }
+    });
+    runOnThreads(numThreads, compress);
+
+    // roots are the smallest vertex of each component, so first appearance keeps that order
+    ComponentResult result;
+    result.component.assign(n, -1);
+    result.count = 0;
+    for (int v = 0; v < n; ++v) {
+        int root = parent[v].load(std::memory_order_relaxed);
+        if (root == v) {
+            result.component[v] = result.count++;
+            result.sizes.push_back(0);
+        } else {
+            result.component[v] = result.component[root];
+        }
+        ++result.sizes[result.component[v]];
+    }
+    return result;
 }
 
+/*=================================================================================================
+Function: condensation
+Description:
+    Builds the component graph: one vertex per component and one edge per pair of distinct
+    components joined by at least one edge. Duplicate checks go through a temporary edge index.
+Parameters:
+    - const ComponentResult& components: labels from one of the components functions.
+Return:
+    - Graph: the condensation.
+=================================================================================================*/
+Graph Graph::condensation(const ComponentResult &components) const {
+    int n = adjList.size();
+    if (static_cast<int>(components.component.size()) != n) {
+        throw std::invalid_argument("condensation: labels do not match the graph");
+    }
+    Graph g(components.count);
+    g.enableEdgeIndex();
+    for (int u = 0; u < n; ++u) {
+        for (int v : adjList[u]) {
+            if (components.component[u] != components.component[v]) {
+                g.addEdge(components.component[u], components.component[v]);
+            }
+        }
+    }
+    g.disableEdgeIndex();
+    return g;
+}
+
+/*=================================================================================================
+Function: freeze
+Description:
+    Builds a read-only CSR (compressed sparse row) snapshot of the graph. All neighbor lists are
+    packed into one contiguous array so traversals on the snapshot do not chase a heap pointer
+    per vertex. Neighbor order is preserved so traversals on the snapshot visit vertices in
+    exactly the same order as on the Graph.
+Parameters:
+    - none
+Return:
+    - CsrGraph: the snapshot, independent of any later changes to this graph.
+=================================================================================================*/
+CsrGraph Graph::freeze() const {
+    int n = adjList.size();
+
+    // prefix sum of the out-degrees gives where each vertex's neighbors start
+    std::vector<long long> offsets(n + 1, 0);
+    for (int u = 0; u < n; ++u) {
+        offsets[u + 1] = offsets[u] + adjList[u].size();
+    }
+
+    // copy every neighbor list into its slice of the targets array
+    std::vector<int> targets;
+    targets.reserve(offsets[n]);
+    for (int u = 0; u < n; ++u) {
+        targets.insert(targets.end(), adjList[u].begin(), adjList[u].end());
+    }
+    return CsrGraph(std::move(offsets), std::move(targets));
+}
+
+/*=================================================================================================
+Function: readFromSTDIN
+Description:
+    Constructs a graph based on data read from a txt file on standard input. The whole input is
+    read in large blocks and parsed in memory, with nothing printed per edge.
+Return:
+    - Graph: a graph object constructed from the input data.
+=================================================================================================*/
+Graph Graph::readFromSTDIN() {
+    // read all of stdin in big blocks, bypassing the formatted iostream layer
+    std::vector<char> text;
+    size_t length = 0;
+    text.resize(1 << 20);
+    size_t got;
+    while ((got = std::fread(text.data() + length, 1, text.size() - length, stdin)) > 0) {
+        length += got;
+        if (length == text.size()) {
+            text.resize(text.size() * 2);
+        }
+    }
+    return parseEdgeList(text.data(), text.data() + length, ProgressCallback(), 1 << 20, "readFromSTDIN");
+}
+
+/*=================================================================================================
+Function: readFromStream
+Description:
+    Reads the whole stream in large blocks and then parses it like readFromSTDIN.
+Parameters:
+    - std::istream& in: the stream to read from.
+    - const ProgressCallback& progress: optional progress report, see readFromBuffer.
+    - long long progressInterval: number of edges between progress reports.
+Return:
+    - Graph: a graph object constructed from the input data.
+=================================================================================================*/
+Graph Graph::readFromStream(std::istream &in, const ProgressCallback &progress, long long progressInterval) {
+    std::vector<char> text;
+    size_t length = 0;
+    text.resize(1 << 20);
+    while (in.read(text.data() + length, text.size() - length) || in.gcount() > 0) {
+        length += in.gcount();
+        if (length == text.size()) {
+            text.resize(text.size() * 2);
+        }
+    }
+    return parseEdgeList(text.data(), text.data() + length, progress, progressInterval, "readFromStream");
+}
+
+/*=================================================================================================
+Function: readFromBuffer
+Description:
+    Parses text already in memory, see parseEdgeList.
+Parameters:
+    - const char* begin, const char* end: the text to parse.
+    - const ProgressCallback& progress: called with (edges read, m) every progressInterval
+      edges and once when done; may be empty.
+    - long long progressInterval: number of edges between progress reports.
+Return:
+    - Graph: a graph object constructed from the input data.
+=================================================================================================*/
+Graph Graph::readFromBuffer(const char *begin, const char *end, const ProgressCallback &progress,
+                            long long progressInterval) {
+    return parseEdgeList(begin, end, progress, progressInterval, "readFromBuffer");
+}
+
+/*=================================================================================================
+Function: parseEdgeList
+Description:
+    Parses "n m" followed by m "u v" pairs from an in-memory text buffer using std::from_chars
+    into an edge array, then builds the graph in bulk with fromEdges, which removes duplicate
+    edges the same way addEdge would.
+Parameters:
+    - const char* begin, const char* end: the text to parse.
+    - const ProgressCallback& progress: see readFromBuffer.
+    - long long progressInterval: see readFromBuffer.
+    - const char* caller: the reader's name, for the error messages.
+Return:
+    - Graph: a graph object constructed from the input data.
+=================================================================================================*/
+Graph Graph::parseEdgeList(const char *begin, const char *end, const ProgressCallback &progress,
+                           long long progressInterval, const char *caller) {
+    const char *p = begin;
+
+    // reads the next integer token, skipping any whitespace in front of it
+    auto next = [&](long long &value) {
+        while (p != end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) {
+            ++p;
+        }
+        std::from_chars_result r = std::from_chars(p, end, value);
+        if (r.ec != std::errc()) {
+            return false;
+        }
+        p = r.ptr;
+        return true;
+    };
+
+    long long n, m;
+    if (!next(n) || !next(m) || n < 0 || m < 0 || n > std::numeric_limits<int>::max()) {
+        throw std::invalid_argument(std::string(caller) + ": expected \"n m\" header");
+    }
+    std::vector<std::pair<int, int> > edges;
+    edges.reserve(std::min<long long>(m, (end - p) / 4)); // an edge takes at least 4 characters
+
+    if (progressInterval < 1) {
+        progressInterval = 1;
+    }
+    for (long long i = 0; i < m; ++i) {
+        long long u, v;
+        if (!next(u) || !next(v)) {
+            throw std::invalid_argument(std::string(caller) + ": expected " + std::to_string(m) + " edges, got " +
+                                        std::to_string(i));
+        }
+        if (u < 0 || u >= n || v < 0 || v >= n) {
+            throw std::out_of_range(std::string(caller) + ": vertex index out of range");
+        }
+        edges.push_back(std::make_pair(static_cast<int>(u), static_cast<int>(v)));
+        if (progress && (i + 1) % progressInterval == 0) {
+            progress(i + 1, m);
+        }
+    }
+    if (progress && (m == 0 || m % progressInterval != 0)) {
+        progress(m, m); // final report, unless the last interval already covered it
+    }
+    return fromEdges(n, edges);
+}
+
+/*=================================================================================================
+Function: fromEdgeBlocks
+Description:
+    Builds every neighbor list at once instead of calling addEdge per edge:
+      1. count the out-degree of every source (atomic counters, duplicates included)
+      2. prefix sum the counts into slices and scatter every edge as (target, input position)
+         into its source's slice; threads claim slots with fetch_add, so the order inside a
+         slice is arbitrary
+      3. per source: sort the slice by (target, position), so each target's first occurrence
+         starts its run, then sort the runs by that position to get back input order; the
+         k-th run becomes the k-th neighbor (and every edge in it gets placement k)
+    Steps 1-2 split the edges across threads and step 3 the sources, so the work is O(m) plus
+    sorting each source's own edges, with no duplicate scans or neighbor list regrowth.
+Parameters:
+    - int n: number of vertices.
+    - const std::vector<std::pair<int, int>>* blocks: the edge buffers, in input order.
+    - size_t numBlocks: number of buffers.
+    - int numThreads: number of threads, <= 0 for one per hardware thread.
+    - std::vector<int>* placement: if not null, filled with each input edge's neighbor index.
+Return:
+    - Graph: the graph with those edges.
+=================================================================================================*/
+Graph Graph::fromEdgeBlocks(int n, const std::vector<std::pair<int, int> > *blocks, size_t numBlocks,
+                            int numThreads, std::vector<int> *placement) {
+    const long long EDGE_CHUNK = 4096; // edges taken per grab
+    const size_t VERTEX_CHUNK = 64; // sources taken per grab
+    const long long MIN_PARALLEL = 1 << 14; // fewer edges are not worth waking threads for
+
+    // edge i of the whole input is blocks[b][i - base[b]]
+    std::vector<long long> base(numBlocks + 1, 0);
+    for (size_t b = 0; b < numBlocks; ++b) {
+        base[b + 1] = base[b] + blocks[b].size();
+    }
+    long long m = base[numBlocks];
+    numThreads = resolveThreadCount(numThreads);
+    int threads = m < MIN_PARALLEL ? 1 : numThreads;
+
+    // calls f(i, edge) for every edge, chunks of the input handed out to the threads
+    auto forEachEdge = [&](const std::function<void(long long, const std::pair<int, int> &)> &f) {
+        std::atomic<long long> cursor(0);
+        runOnThreads(threads, [&](int) {
+            long long begin;
+            while ((begin = cursor.fetch_add(EDGE_CHUNK, std::memory_order_relaxed)) < m) {
+                long long end = std::min(begin + EDGE_CHUNK, m);
+                size_t b = std::upper_bound(base.begin(), base.end(), begin) - base.begin() - 1;
+                for (long long i = begin; i < end; ++i) {
+                    while (i == base[b + 1]) {
+                        ++b; // skip to the block holding edge i (jumping over empty ones)
+                    }
+                    f(i, blocks[b][i - base[b]]);
+                }
+            }
+        });
+    };
+
+    std::vector<std::atomic<long long> > fill(n);
+    for (int u = 0; u < n; ++u) {
+        fill[u].store(0, std::memory_order_relaxed);
+    }
+    forEachEdge([&](long long, const std::pair<int, int> &e) {
+        if (e.first < 0 || e.first >= n || e.second < 0 || e.second >= n) {
+            throw std::out_of_range("fromEdges: vertex index out of range");
+        }
+        fill[e.first].fetch_add(1, std::memory_order_relaxed);
+    });
+
+    std::vector<long long> offsets(n + 1, 0);
+    for (int u = 0; u < n; ++u) {
+        offsets[u + 1] = offsets[u] + fill[u].load(std::memory_order_relaxed);
+        fill[u].store(offsets[u], std::memory_order_relaxed);
+    }
+
+    std::vector<std::pair<int, long long> > slots(m); // (target, input position)
+    forEachEdge([&](long long i, const std::pair<int, int> &e) {
+        slots[fill[e.first].fetch_add(1, std::memory_order_relaxed)] = std::make_pair(e.second, i);
+    });
+
+    Graph g(n);
+    if (placement != nullptr) {
+        placement->assign(m, 0);
+    }
+    std::atomic<size_t> cursor(0);
+    runOnThreads(threads, [&](int) {
+        std::vector<std::pair<long long, long long> > runs; // (first position, run start in slots)
+        size_t begin;
+        while ((begin = cursor.fetch_add(VERTEX_CHUNK, std::memory_order_relaxed)) < static_cast<size_t>(n)) {
+            size_t end = std::min(begin + VERTEX_CHUNK, static_cast<size_t>(n));
+            for (size_t u = begin; u < end; ++u) {
+                std::sort(slots.begin() + offsets[u], slots.begin() + offsets[u + 1]);
+                runs.clear();
+                for (long long i = offsets[u]; i < offsets[u + 1]; ++i) {
+                    if (i == offsets[u] || slots[i].first != slots[i - 1].first) {
+                        runs.push_back(std::make_pair(slots[i].second, i));
+                    }
+                }
+                std::sort(runs.begin(), runs.end());
+
+                g.adjList[u].reserve(runs.size());
+                for (size_t k = 0; k < runs.size(); ++k) {
+                    int v = slots[runs[k].second].first;
+                    g.adjList[u].push_back(v);
+                    if (placement != nullptr) {
+                        for (long long i = runs[k].second; i < offsets[u + 1] && slots[i].first == v; ++i) {
+                            (*placement)[slots[i].second] = k;
+                        }
+                    }
+                }
+            }
+        }
+    });
+    return g;
+}
+
+/*=================================================================================================
+Function: fromEdges
+Description:
+    Bulk construction from an edge array, see fromEdgeBlocks.
+Parameters:
+    - int n: number of vertices.
+    - const std::vector<std::pair<int, int>>& edges: the (u, v) edges in insertion order.
+    - int numThreads: number of threads, <= 0 for one per hardware thread.
+Return:
+    - Graph: the graph with those edges.
+=================================================================================================*/
+Graph Graph::fromEdges(int n, const std::vector<std::pair<int, int> > &edges, int numThreads) {
+    if (n < 0) {
+        throw std::invalid_argument("fromEdges: negative vertex count");
+    }
+    return fromEdgeBlocks(n, &edges, 1, numThreads);
+}
+
+/*=================================================================================================
+Function: parallelReadFromBuffer
+Description:
+    Parses the "n m" header, then cuts the rest of the text into about four chunks per thread
+    (at least 64 KB each). Every chunk boundary is moved forward to just after the next line
+    break, so each line belongs to exactly one chunk. Threads take chunks in turn and parse
+    each into its own edge buffer with std::from_chars; the buffers stay in text order, are cut
+    to the first m edges, and are handed to fromEdgeBlocks. A chunk stops at its first bad
+    line and keeps the error; the error is only thrown if, once the chunks before it are
+    counted, the bad line falls within the first m edges.
+Parameters:
+    - const char* begin, const char* end: the text to parse.
+    - int numThreads: number of threads, <= 0 for one per hardware thread.
+Return:
+    - Graph: a graph object constructed from the input data.
+=================================================================================================*/
+Graph Graph::parallelReadFromBuffer(const char *begin, const char *end, int numThreads) {
+    const size_t MIN_CHUNK = 1 << 16; // bytes
+
+    const char *p = begin;
+    long long n, m;
+    if (!parseHeader(p, end, n, m)) {
+        throw std::invalid_argument("parallelReadFromBuffer: expected \"n m\" header");
+    }
+
+    // chunk boundaries, each just after a line break (or at the ends of the text)
+    numThreads = resolveThreadCount(numThreads);
+    size_t length = end - p;
+    size_t numChunks = std::max<size_t>(1, std::min<size_t>(4 * numThreads, length / MIN_CHUNK));
+    std::vector<const char *> bounds(numChunks + 1);
+    bounds[0] = p;
+    for (size_t c = 1; c < numChunks; ++c) {
+        const char *q = std::max(bounds[c - 1], p + length * c / numChunks);
+        while (q != end && q[-1] != '\n') {
+            ++q;
+        }
+        bounds[c] = q;
+    }
+    bounds[numChunks] = end;
+
+    std::vector<std::vector<std::pair<int, int> > > blocks(numChunks);
+    std::vector<std::exception_ptr> errors(numChunks);
+    std::atomic<size_t> next(0);
+    runOnThreads(std::min<size_t>(numThreads, numChunks), [&](int) {
+        size_t c;
+        while ((c = next.fetch_add(1, std::memory_order_relaxed)) < numChunks) {
+            try {
+                parseEdgeLines(bounds[c], bounds[c + 1], n, blocks[c], "parallelReadFromBuffer");
+            } catch (...) {
+                errors[c] = std::current_exception(); // only fatal if it is within the first m edges
+            }
+        }
+    });
+    return fromParsedBlocks(n, m, blocks, errors, numThreads, "parallelReadFromBuffer");
+}
+
+/*=================================================================================================
+Function: parseHeader
+Description:
+    Reads the two header integers, skipping whitespace (line breaks included) in front of
+    each.
+Parameters:
+    - const char*& p: current position, moved past the header.
+    - const char* end: end of the text.
+    - long long& n, long long& m: the vertex and edge counts.
+Return:
+    - bool: true if both were read and are in range.
+=================================================================================================*/
+bool Graph::parseHeader(const char *&p, const char *end, long long &n, long long &m) {
+    for (long long *value : {&n, &m}) {
+        while (p != end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) {
+            ++p;
+        }
+        std::from_chars_result r = std::from_chars(p, end, *value);
+        if (r.ec != std::errc()) {
+            return false;
+        }
+        p = r.ptr;
+    }
+    return n >= 0 && m >= 0 && n <= std::numeric_limits<int>::max();
+}
+
+/*=================================================================================================
+Function: parseEdgeLines
+Description:
+    Parses a run of whole "u v" lines (blank lines allowed) and appends the edges. On a bad
+    line it throws, and edges holds the edges of the lines before it.
+Parameters:
+    - const char* begin, const char* end: the lines; end is at a line break or the end of input.
+    - long long n: number of vertices, for the range check.
+    - std::vector<std::pair<int, int>>& edges: where the edges go.
+    - const char* caller: the loader's name, for the error messages.
+Return:
+    - nothing
+=================================================================================================*/
+void Graph::parseEdgeLines(const char *begin, const char *end, long long n, std::vector<std::pair<int, int> > &edges,
+                           const char *caller) {
+    auto skipBlanks = [](const char *q, const char *stop) {
+        while (q != stop && (*q == ' ' || *q == '\t' || *q == '\r')) {
+            ++q;
+        }
+        return q;
+    };
+
+    edges.reserve(edges.size() + (end - begin) / 8);
+    for (const char *q = begin; q != end;) {
+        q = skipBlanks(q, end);
+        if (q == end) {
+            break;
+        }
+        if (*q == '\n') {
+            ++q; // blank line
+            continue;
+        }
+        long long u, v;
+        std::from_chars_result r = std::from_chars(q, end, u);
+        if (r.ec == std::errc()) {
+            r = std::from_chars(skipBlanks(r.ptr, end), end, v);
+        }
+        if (r.ec == std::errc()) {
+            q = skipBlanks(r.ptr, end);
+        }
+        if (r.ec != std::errc() || (q != end && *q != '\n')) {
+            throw std::invalid_argument(std::string(caller) + ": expected one \"u v\" edge per line");
+        }
+        if (u < 0 || u >= n || v < 0 || v >= n) {
+            throw std::out_of_range(std::string(caller) + ": vertex index out of range");
+        }
+        edges.push_back(std::make_pair(static_cast<int>(u), static_cast<int>(v)));
+        if (q != end) {
+            ++q;
+        }
+    }
+}
+
+/*=================================================================================================
+Function: fromParsedBlocks
+Description:
+    Cuts the parsed buffers (in text order) to the first m edges and builds the graph with
+    fromEdgeBlocks. A buffer's error is rethrown only if the edges before it, in this and
+    earlier buffers, are fewer than m; otherwise the bad line comes after the edges the header
+    asks for and is ignored, as readFromBuffer does.
+Parameters:
+    - long long n, long long m: the header counts.
+    - std::vector<std::vector<std::pair<int, int>>>& blocks: the parsed buffers, trimmed in place.
+    - const std::vector<std::exception_ptr>& errors: errors[i] is set if blocks[i] stopped at a
+      bad line (may be shorter than blocks).
+    - int numThreads: number of threads, <= 0 for one per hardware thread.
+    - const char* caller: the loader's name, for the error messages.
+Return:
+    - Graph: the graph.
+=================================================================================================*/
+Graph Graph::fromParsedBlocks(long long n, long long m, std::vector<std::vector<std::pair<int, int> > > &blocks,
+                              const std::vector<std::exception_ptr> &errors, int numThreads, const char *caller) {
+    long long kept = 0;
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        long long take = std::min<long long>(blocks[i].size(), m - kept);
+        blocks[i].resize(take);
+        kept += take;
+        if (kept < m && i < errors.size() && errors[i]) {
+            std::rethrow_exception(errors[i]);
+        }
+    }
+    if (kept < m) {
+        throw std::invalid_argument(std::string(caller) + ": expected " + std::to_string(m) + " edges, got " +
+                                    std::to_string(kept));
+    }
+    return fromEdgeBlocks(n, blocks.data(), blocks.size(), numThreads);
+}
+
+/*=================================================================================================
+Function: parallelReadFromFile
+Description:
+    Maps the file read-only and parses it in place with parallelReadFromBuffer, so the text is
+    never copied into the process and the threads read their chunks straight from the page
+    cache.
+Parameters:
+    - const std::string& path: the file to read.
+    - int numThreads: number of threads, <= 0 for one per hardware thread.
+Return:
+    - Graph: a graph object constructed from the file.
+=================================================================================================*/
+Graph Graph::parallelReadFromFile(const std::string &path, int numThreads) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("parallelReadFromFile: cannot open " + path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("parallelReadFromFile: cannot stat " + path);
+    }
+    size_t size = info.st_size;
+    if (size == 0) {
+        ::close(fd);
+        return parallelReadFromBuffer(nullptr, nullptr, numThreads); // reports the missing header
+    }
+    void *base = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        throw std::runtime_error("parallelReadFromFile: cannot map " + path);
+    }
+    std::unique_ptr<void, std::function<void(void *)> > mapping(base, [size](void *q) { munmap(q, size); });
+
+    const char *text = static_cast<const char *>(base);
+    return parallelReadFromBuffer(text, text + size, numThreads);
+}
+
+#ifdef GRAPH_WITH_ZLIB
+/*=================================================================================================
+Function: readGzip
+Description:
+    Three stages overlap:
+      - the decompressor thread gzreads 1 MB at a time, parses the "n m" header from the
+        start of the data, and cuts every block after its last line break (the rest is carried
+        into the next block), so each block holds whole lines
+      - parser threads take blocks from a queue and parse them with parseEdgeLines into a
+        buffer per block number, so the buffers stay in file order
+      - fromParsedBlocks builds the graph from the buffers with the parallel counting sort
+    The queue holds at most two blocks per parser, which bounds the decompressed text kept in
+    memory and makes the decompressor wait when parsing falls behind. A bad line is kept with
+    its block and left to fromParsedBlocks, since it only matters if it is within the first m
+    edges; any other exception tells the other stages to stop and is rethrown.
+Parameters:
+    - const std::string& path: the file to read.
+    - int numThreads: total threads (decompressor + parsers), <= 0 for one per hardware thread.
+Return:
+    - Graph: a graph object constructed from the file.
+=================================================================================================*/
+Graph Graph::readGzip(const std::string &path, int numThreads) {
+    const unsigned BLOCK = 1 << 20; // decompressed bytes per read
+    const size_t HEADER_LIMIT = 4096; // stop waiting for a complete header after this many bytes
+
+    gzFile file = gzopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        throw std::runtime_error("readGzip: cannot open " + path);
+    }
+    std::unique_ptr<gzFile_s, int (*)(gzFile)> closer(file, gzclose);
+    gzbuffer(file, 1 << 17);
+
+    numThreads = resolveThreadCount(numThreads);
+    int parsers = std::max(1, numThreads - 1);
+    size_t capacity = 2 * parsers;
+
+    std::mutex lock;
+    std::condition_variable changed; // queue gained or lost a block, or a stage finished
+    std::deque<std::pair<size_t, std::vector<char> > > queue; // (block number, text)
+    bool finished = false; // the decompressor has queued its last block
+    bool failed = false; // a stage threw, the others stop
+    long long n = -1, m = -1;
+    std::vector<std::vector<std::pair<int, int> > > blocks;
+    std::vector<std::exception_ptr> errors; // bad line per block number, see fromParsedBlocks
+
+    auto decompress = [&]() {
+        std::vector<char> carry; // unfinished line (or header) from the previous read
+        bool header = false;
+        size_t index = 0;
+        while (true) {
+            std::vector<char> text(carry.size() + BLOCK);
+            std::copy(carry.begin(), carry.end(), text.begin());
+            int got = gzread(file, text.data() + carry.size(), BLOCK);
+            if (got < 0) {
+                int code;
+                throw std::runtime_error("readGzip: " + std::string(gzerror(file, &code)));
+            }
+            text.resize(carry.size() + got);
+            carry.clear();
+            bool eof = got == 0;
+            if (eof) {
+                // a stream that ends early is only reported here, after the data before the cut
+                int code;
+                const char *message = gzerror(file, &code);
+                if (code != Z_OK) {
+                    throw std::runtime_error("readGzip: " + std::string(message));
+                }
+            }
+
+            if (!header) {
+                const char *p = text.data();
+                long long vertices, edges;
+                bool ok = parseHeader(p, text.data() + text.size(), vertices, edges);
+                if ((!ok || p == text.data() + text.size()) && !eof && text.size() < HEADER_LIMIT) {
+                    carry.swap(text); // a number may continue in the next read
+                    continue;
+                }
+                if (!ok) {
+                    throw std::invalid_argument("readGzip: expected \"n m\" header");
+                }
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    n = vertices;
+                    m = edges;
+                }
+                text.erase(text.begin(), text.begin() + (p - text.data()));
+                header = true;
+            }
+
+            if (!eof) {
+                size_t cut = text.size();
+                while (cut > 0 && text[cut - 1] != '\n') {
+                    --cut;
+                }
+                carry.assign(text.begin() + cut, text.end());
+                text.resize(cut);
+            }
+            if (!text.empty()) {
+                std::unique_lock<std::mutex> guard(lock);
+                changed.wait(guard, [&]() { return queue.size() < capacity || failed; });
+                if (failed) {
+                    return;
+                }
+                queue.push_back(std::make_pair(index++, std::move(text)));
+                guard.unlock();
+                changed.notify_all();
+            }
+            if (eof) {
+                break;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            finished = true;
+        }
+        changed.notify_all();
+    };
+
+    auto parse = [&]() {
+        while (true) {
+            std::pair<size_t, std::vector<char> > block;
+            long long vertices;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                changed.wait(guard, [&]() { return !queue.empty() || finished || failed; });
+                if (failed || queue.empty()) {
+                    return; // stopped, or everything is parsed
+                }
+                block = std::move(queue.front());
+                queue.pop_front();
+                vertices = n;
+            }
+            changed.notify_all(); // room for the decompressor
+
+            std::vector<std::pair<int, int> > edges;
+            std::exception_ptr error;
+            try {
+                parseEdgeLines(block.second.data(), block.second.data() + block.second.size(), vertices, edges,
+                               "readGzip");
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> guard(lock);
+            if (blocks.size() <= block.first) {
+                blocks.resize(block.first + 1);
+                errors.resize(block.first + 1);
+            }
+            blocks[block.first].swap(edges);
+            errors[block.first] = error;
+        }
+    };
+
+    // the last thread decompresses, the others parse
+    runOnThreads(parsers + 1, [&](int t) {
+        try {
+            if (t == parsers) {
+                decompress();
+            } else {
+                parse();
+            }
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                failed = true;
+            }
+            changed.notify_all();
+            throw;
+        }
+    });
+
+    return fromParsedBlocks(n, m, blocks, errors, numThreads, "readGzip");
+}
+#endif
+
+/*=================================================================================================
+Function: forEachLine
+Description:
+    Reads the stream in 1 MB blocks and hands out every complete line; the unfinished line at
+    the end of a block is moved to the front before the next read (the buffer doubles if a
+    single line does not fit). A last line without a '\n' is handed out at end of input.
+Parameters:
+    - std::istream& in: the stream to read.
+    - F f: called as f(long long lineNumber, const char* begin, const char* end).
+Return:
+    - nothing
+=================================================================================================*/
+template <typename F>
+void Graph::forEachLine(std::istream &in, F f) {
+    std::vector<char> buffer(1 << 20);
+    size_t kept = 0; // bytes of the unfinished line at the front of the buffer
+    long long lineNumber = 0;
+    while (true) {
+        in.read(buffer.data() + kept, buffer.size() - kept);
+        size_t got = in.gcount();
+        const char *p = buffer.data();
+        const char *end = p + kept + got;
+
+        const char *newline;
+        while ((newline = static_cast<const char *>(std::memchr(p, '\n', end - p))) != nullptr) {
+            f(++lineNumber, p, newline);
+            p = newline + 1;
+        }
+        kept = end - p;
+        if (got == 0) {
+            if (kept > 0) {
+                f(++lineNumber, p, end);
+            }
+            return;
+        }
+        std::memmove(buffer.data(), p, kept);
+        if (kept == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+    }
+}
+
+/*=================================================================================================
+Function: nextInteger
+Description:
+    Token reader for the line-based formats.
+Parameters:
+    - const char*& p: current position, moved past the integer.
+    - const char* end: end of the line.
+    - long long& value: the integer read.
+Return:
+    - bool: true if an integer was read.
+=================================================================================================*/
+bool Graph::nextInteger(const char *&p, const char *end, long long &value) {
+    while (p != end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        ++p;
+    }
+    std::from_chars_result r = std::from_chars(p, end, value);
+    if (r.ec != std::errc()) {
+        return false;
+    }
+    p = r.ptr;
+    return true;
+}
+
+/*=================================================================================================
+Function: readSNAP
+Description:
+    Reads a SNAP edge list. The vertex count is not stored in these files, so it is taken as
+    the largest id seen plus one once all edges are in.
+Parameters:
+    - std::istream& in: the stream to read.
+    - int numThreads: threads for fromEdges.
+Return:
+    - Graph: the graph.
+=================================================================================================*/
+Graph Graph::readSNAP(std::istream &in, int numThreads) {
+    std::vector<std::pair<int, int> > edges;
+    long long largest = -1;
+    forEachLine(in, [&](long long line, const char *p, const char *end) {
+        while (p != end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+            ++p;
+        }
+        if (p == end || *p == '#') {
+            return; // blank or comment
+        }
+        long long u, v;
+        if (!nextInteger(p, end, u) || !nextInteger(p, end, v)) {
+            throw std::invalid_argument("readSNAP: line " + std::to_string(line) + ": expected \"u v\"");
+        }
+        if (u < 0 || v < 0 || u >= std::numeric_limits<int>::max() || v >= std::numeric_limits<int>::max()) {
+            throw std::out_of_range("readSNAP: line " + std::to_string(line) + ": vertex id out of range");
+        }
+        largest = std::max(largest, std::max(u, v));
+        edges.push_back(std::make_pair(static_cast<int>(u), static_cast<int>(v)));
+    });
+    return fromEdges(largest + 1, edges, numThreads);
+}
+
+/*=================================================================================================
+Function: readMatrixMarket
+Description:
+    Reads a Matrix Market coordinate file: the "%%MatrixMarket matrix coordinate <field>
+    <symmetry>" banner, '%' comment lines, the "rows cols entries" size line, then one entry
+    "i j [value]" per line with 1-based indices. Dense ("array") files are rejected.
+Parameters:
+    - std::istream& in: the stream to read.
+    - int numThreads: threads for fromEdges.
+Return:
+    - Graph: the graph.
+=================================================================================================*/
+Graph Graph::readMatrixMarket(std::istream &in, int numThreads) {
+    std::vector<std::pair<int, int> > edges;
+    bool symmetric = false;
+    long long rows = -1, cols = -1, entries = -1, read = 0;
+
+    forEachLine(in, [&](long long line, const char *p, const char *end) {
+        auto where = [&]() { return "readMatrixMarket: line " + std::to_string(line) + ": "; };
+        if (line == 1) {
+            std::string banner(p, end);
+            for (char &c : banner) {
+                c = std::tolower(static_cast<unsigned char>(c));
+            }
+            std::istringstream words(banner);
+            std::string magic, object, format, field, symmetry;
+            words >> magic >> object >> format >> field >> symmetry;
+            if (magic != "%%matrixmarket" || object != "matrix") {
+                throw std::invalid_argument(where() + "expected a %%MatrixMarket matrix banner");
+            }
+            if (format != "coordinate") {
+                throw std::invalid_argument(where() + "only coordinate matrices describe a graph");
+            }
+            if (symmetry != "general" && symmetry != "symmetric" && symmetry != "skew-symmetric" &&
+                symmetry != "hermitian") {
+                throw std::invalid_argument(where() + "unknown symmetry \"" + symmetry + "\"");
+            }
+            symmetric = symmetry != "general";
+            return;
+        }
+        while (p != end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+            ++p;
+        }
+        if (p == end || *p == '%') {
+            return; // blank or comment
+        }
+
+        if (rows < 0) {
+            if (!nextInteger(p, end, rows) || !nextInteger(p, end, cols) || !nextInteger(p, end, entries) ||
+                rows < 0 || cols < 0 || entries < 0 || std::max(rows, cols) > std::numeric_limits<int>::max()) {
+                throw std::invalid_argument(where() + "expected \"rows cols entries\"");
+            }
+            edges.reserve(std::min<long long>(entries, 1 << 24) * (symmetric ? 2 : 1));
+            return;
+        }
+
+        long long i, j;
+        if (!nextInteger(p, end, i) || !nextInteger(p, end, j)) {
+            throw std::invalid_argument(where() + "expected \"i j [value]\"");
+        }
+        if (i < 1 || i > rows || j < 1 || j > cols) {
+            throw std::out_of_range(where() + "entry outside the matrix");
+        }
+        if (++read > entries) {
+            throw std::invalid_argument(where() + "more entries than the size line declares");
+        }
+        edges.push_back(std::make_pair(static_cast<int>(i - 1), static_cast<int>(j - 1)));
+        if (symmetric && i != j) {
+            edges.push_back(std::make_pair(static_cast<int>(j - 1), static_cast<int>(i - 1)));
+        }
+    });
+
+    if (rows < 0) {
+        throw std::invalid_argument("readMatrixMarket: missing banner or size line");
+    }
+    if (read < entries) {
+        throw std::invalid_argument("readMatrixMarket: expected " + std::to_string(entries) + " entries, got " +
+                                    std::to_string(read));
+    }
+    return fromEdges(std::max(rows, cols), edges, numThreads);
+}
+
+/*=================================================================================================
+Function: readMETIS
+Description:
+    Reads a METIS graph file. The optional fmt field is three digits: vertex sizes, vertex
+    weights (ncon of them, default 1) and edge weights; all of them are read past. '%' lines are
+    comments, while an empty line is a vertex with no neighbors. The number of neighbor
+    entries must be 2m.
+Parameters:
+    - std::istream& in: the stream to read.
+    - int numThreads: threads for fromEdges.
+Return:
+    - Graph: the graph.
+=================================================================================================*/
+Graph Graph::readMETIS(std::istream &in, int numThreads) {
+    std::vector<std::pair<int, int> > edges;
+    long long n = -1, m = -1, u = 0;
+    bool hasSizes = false, hasEdgeWeights = false;
+    long long vertexWeights = 0;
+
+    forEachLine(in, [&](long long line, const char *p, const char *end) {
+        auto where = [&]() { return "readMETIS: line " + std::to_string(line) + ": "; };
+        const char *first = p;
+        while (first != end && (*first == ' ' || *first == '\t' || *first == '\r')) {
+            ++first;
+        }
+        if (first != end && *first == '%') {
+            return; // comment
+        }
+
+        if (n < 0) {
+            if (first == end) {
+                return; // blank lines before the header
+            }
+            long long fmt = 0, ncon = 1;
+            if (!nextInteger(p, end, n) || !nextInteger(p, end, m) || n < 0 || m < 0 ||
+                n > std::numeric_limits<int>::max()) {
+                throw std::invalid_argument(where() + "expected \"n m [fmt [ncon]]\"");
+            }
+            if (nextInteger(p, end, fmt)) {
+                nextInteger(p, end, ncon);
+            }
+            if (p != end || fmt < 0 || fmt > 111 || fmt % 10 > 1 || fmt / 10 % 10 > 1 || ncon < 1) {
+                throw std::invalid_argument(where() + "expected \"n m [fmt [ncon]]\"");
+            }
+            hasSizes = fmt / 100 == 1;
+            vertexWeights = fmt / 10 % 10 == 1 ? ncon : 0;
+            hasEdgeWeights = fmt % 10 == 1;
+            edges.reserve(std::min<long long>(2 * m, 1 << 24));
+            return;
+        }
+
+        if (u == n) {
+            if (first != end) {
+                throw std::invalid_argument(where() + "more vertex lines than the header declares");
+            }
+            return; // trailing blank lines
+        }
+        long long skip = (hasSizes ? 1 : 0) + vertexWeights, value;
+        for (long long k = 0; k < skip; ++k) {
+            if (!nextInteger(p, end, value)) {
+                throw std::invalid_argument(where() + "missing vertex size or weight");
+            }
+        }
+        long long v;
+        while (nextInteger(p, end, v)) {
+            if (v < 1 || v > n) {
+                throw std::out_of_range(where() + "neighbor outside the graph");
+            }
+            if (hasEdgeWeights && !nextInteger(p, end, value)) {
+                throw std::invalid_argument(where() + "missing edge weight");
+            }
+            edges.push_back(std::make_pair(static_cast<int>(u), static_cast<int>(v - 1)));
+        }
+        if (p != end) {
+            throw std::invalid_argument(where() + "expected 1-based neighbor numbers");
+        }
+        ++u;
+    });
+
+    if (n < 0) {
+        throw std::invalid_argument("readMETIS: missing header");
+    }
+    if (u < n) {
+        throw std::invalid_argument("readMETIS: expected " + std::to_string(n) + " vertex lines, got " +
+                                    std::to_string(u));
+    }
+    if (static_cast<long long>(edges.size()) != 2 * m) {
+        throw std::invalid_argument("readMETIS: header declares " + std::to_string(m) + " edges but " +
+                                    std::to_string(edges.size()) + " neighbor entries were listed");
+    }
+    return fromEdges(n, edges, numThreads);
+}
+
+/*=================================================================================================
+Constructor: CsrGraph
+Description:
+    Takes ownership of already built offsets and targets arrays. Both are moved into one
+    shared block that the raw array pointers point into.
+Parameters:
+    - std::vector<long long> offsets: n + 1 prefix sums of the out-degrees.
+    - std::vector<int> targets: the neighbors of every vertex, back to back.
+=================================================================================================*/
+CsrGraph::CsrGraph(std::vector<long long> offsets, std::vector<int> targets) {
+    struct Arrays {
+        std::vector<long long> offsets;
+        std::vector<int> targets;
+    };
+    std::shared_ptr<Arrays> arrays = std::make_shared<Arrays>();
+    arrays->offsets = std::move(offsets);
+    arrays->targets = std::move(targets);
+
+    storage = arrays;
+    this->offsets = arrays->offsets.data();
+    this->targets = arrays->targets.data();
+    n = arrays->offsets.size() - 1;
+    m = arrays->targets.size();
+}
+
+/*=================================================================================================
+Constructor: CsrGraph
+Description:
+    View over arrays owned by someone else (a file mapping). storage must keep them alive.
+Parameters:
+    - std::shared_ptr<const void> storage: owner of the arrays.
+    - const long long* offsets: n + 1 prefix sums of the out-degrees.
+    - const int* targets: m neighbors.
+    - int n: number of vertices.
+    - long long m: number of edges.
+=================================================================================================*/
+CsrGraph::CsrGraph(std::shared_ptr<const void> storage, const long long *offsets, const int *targets, int n,
+                   long long m)
+    : storage(storage), offsets(offsets), targets(targets), n(n), m(m) {}
+
+/*=================================================================================================
+Function: numVertices / numEdges
+Description:
+    Size of the snapshot.
+Return:
+    - the number of vertices / directed edges.
+=================================================================================================*/
+int CsrGraph::numVertices() const {
+    return n;
+}
+
+long long CsrGraph::numEdges() const {
+    return m;
+}
+
+/*=================================================================================================
+Function: vertexIn
+Description:
+    Checks whether a given vertex index exists in the snapshot.
+Parameters:
+    - int u: the vertex index to check.
+Return:
+    - bool: true if vertex u is valid, false otherwise.
+=================================================================================================*/
+bool CsrGraph::vertexIn(int u) const {
+    return u >= 0 && u < numVertices();
+}
+
+/*=================================================================================================
+Function: outDegree
+Description:
+    Number of edges leaving u.
+Parameters:
+    - int u: the vertex.
+Return:
+    - int: the out-degree of u.
+=================================================================================================*/
+int CsrGraph::outDegree(int u) const {
+    if (!vertexIn(u)) {
+        throw std::out_of_range("outDegree: vertex index out of range");
+    }
+    return offsets[u + 1] - offsets[u];
+}
+
+/*=================================================================================================
+Function: neighborsBegin / neighborsEnd
+Description:
+    Pointer range over the neighbors of u inside the targets array. No bounds checking is done
+    so these can be used in inner loops.
+Parameters:
+    - int u: the vertex.
+Return:
+    - const int*: start / one-past-the-end of u's neighbors.
+=================================================================================================*/
+const int* CsrGraph::neighborsBegin(int u) const {
+    return targets + offsets[u];
+}
+
+const int* CsrGraph::neighborsEnd(int u) const {
+    return targets + offsets[u + 1];
+}
+
+/*=================================================================================================
+Function: transpose
+Description:
+    Builds the reversed snapshot with a counting sort: count the in-degrees, prefix sum them
+    into offsets, then scatter every edge (u, v) into v's slice. Sources are scanned in
+    increasing order, so each reversed neighbor list comes out sorted.
+Parameters:
+    - none
+Return:
+    - CsrGraph: the transposed snapshot.
+=================================================================================================*/
+CsrGraph CsrGraph::transpose() const {
+    std::vector<long long> reversedOffsets(n + 1, 0);
+    std::vector<int> reversedTargets(m);
+
+    for (long long i = 0; i < m; ++i) {
+        ++reversedOffsets[targets[i] + 1];
+    }
+    for (int v = 0; v < n; ++v) {
+        reversedOffsets[v + 1] += reversedOffsets[v];
+    }
+    std::vector<long long> fill(reversedOffsets.begin(), reversedOffsets.end() - 1);
+    for (int u = 0; u < n; ++u) {
+        for (long long i = offsets[u]; i < offsets[u + 1]; ++i) {
+            reversedTargets[fill[targets[i]]++] = u;
+        }
+    }
+    return CsrGraph(std::move(reversedOffsets), std::move(reversedTargets));
+}
+
+/*=================================================================================================
+Function: breadthFirstSearch
+Description:
+    Same BFS as Graph::breadthFirstSearch but scanning the contiguous targets array. The queue
+    is a plain vector with a read index since every vertex is pushed at most once.
+Parameters:
+    - int s: the source vertex to start BFS from.
+Return:
+    - std::vector<TraversalData>: visited status, parent, and distance from s for each vertex.
+=================================================================================================*/
+std::vector<TraversalData> CsrGraph::breadthFirstSearch(int s) const {
+    if (!vertexIn(s))
+    throw std::out_of_range("BFS: source not in graph");
+
+    std::vector<TraversalData> data(n);
+    for (int i = 0; i < n; ++i) {
+        data[i].visited = false;
+        data[i].parent = -1;
+        data[i].distance = std::numeric_limits<int>::max();
+    }
+
+    // vertices are appended when discovered and read back in the same order
+    std::vector<int> queue;
+    queue.reserve(n);
+
+    data[s].visited = true;
+    data[s].distance = 0;
+    queue.push_back(s);
+
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int u = queue[head];
+        for (const int *it = neighborsBegin(u), *end = neighborsEnd(u); it != end; ++it) {
+            int v = *it;
+            if (!data[v].visited) {
+                data[v].visited = true;
+                data[v].parent = u;
+                data[v].distance = data[u].distance + 1;
+                queue.push_back(v);
+            }
+        }
+    }
+    return data;
+}
+
+/*=================================================================================================
+Function: depthFirstSearch
+Description:
+    Same DFS as Graph::depthFirstSearch (discovery, finish, parent and topological order), but
+    driven by an explicit stack so very deep graphs cannot overflow the call stack. Each stack
+    entry remembers how far through its neighbor slice the vertex has got.
+Parameters:
+    - None
+Return:
+    - std::vector<TraversalData>: a vector containing traversal data for each vertex.
+=================================================================================================*/
+std::vector<TraversalData> CsrGraph::depthFirstSearch() const {
+    std::vector<TraversalData> data(n);
+    for (int i = 0; i < n; ++i) {
+        data[i].visited = false;
+        data[i].parent = -1;
+    }
+
+    int time = 0;
+    int order = n;
+
+    // (vertex, position in targets of the next neighbor to look at)
+    std::vector<std::pair<int, long long> > stack;
+
+    for (int root = 0; root < n; ++root) {
+        if (data[root].visited) {
+            continue;
+        }
+        data[root].visited = true;
+        data[root].discovery = ++time;
+        stack.push_back(std::make_pair(root, offsets[root]));
+
+        while (!stack.empty()) {
+            int u = stack.back().first;
+            long long &next = stack.back().second;
+
+            // skip neighbors that were already visited
+            while (next < offsets[u + 1] && data[targets[next]].visited) {
+                ++next;
+            }
+
+            if (next < offsets[u + 1]) {
+                // descend into the first unvisited neighbor
+                int v = targets[next++];
+                data[v].visited = true;
+                data[v].parent = u;
+                data[v].discovery = ++time;
+                stack.push_back(std::make_pair(v, offsets[v]));
+            } else {
+                // all neighbors done, u finishes
+                data[u].finish = ++time;
+                data[u].order = order--;
+                stack.pop_back();
+            }
+        }
+    }
+    return data;
+}
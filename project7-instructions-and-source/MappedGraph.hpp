@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include "Graph.hpp"
+#include "WeightedGraph.hpp"
+
+// read-only graph opened straight from a binary file with mmap
+// file layout (all integers in the byte order of the machine that wrote it):
+//   64-byte header: magic "GRAPHBIN", version, byte order mark, vertex and edge counts,
+//                   weight size and kind (0 = no weights), FNV-1a checksum of everything after
+//                   the header
+//   offsets:  (n + 1) int64 prefix sums of the out-degrees
+//   targets:  m int32 neighbors, in the graph's neighbor order
+//   weights:  m weights aligned with targets, starting on an 8-byte boundary (optional)
+// nothing is parsed or copied on open, so the arrays are paged in on first touch
+class MappedGraph {
+    private:
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byteOrder; // 0x01020304 as written
+        std::uint64_t numVertices;
+        std::uint64_t numEdges;
+        std::uint32_t weightSize; // bytes per weight, 0 if the file has no weights
+        std::uint32_t weightKind; // 0 = signed integer, 1 = unsigned integer, 2 = floating point
+        std::uint64_t checksum;
+        std::uint64_t reserved[2];
+    };
+    static_assert(sizeof(Header) == 64, "MappedGraph header must be 64 bytes");
+
+    CsrGraph csr;
+    const char *weightData; // nullptr if the file has no weights
+    std::uint32_t weightSize;
+    std::uint32_t weightKind;
+
+    MappedGraph(CsrGraph csr, const char *weightData, std::uint32_t weightSize, std::uint32_t weightKind);
+
+    template <typename W>
+    static std::uint32_t kindOf(void);
+
+    // streams the file twice through emit: once to checksum the payload, once to write it
+    // weightsOf(u) returns the first byte of u's weights (ignored if weightSize is 0)
+    static void write(const Graph &g, std::function<const char*(int)> weightsOf, std::uint32_t weightSize,
+                      std::uint32_t weightKind, std::ostream &out);
+
+    public:
+    // write g in the binary format
+    // throw an std::runtime_error exception if the stream fails
+    static void write(const Graph &g, std::ostream &out);
+    template <typename W>
+    static void write(const WeightedGraph<W> &g, std::ostream &out);
+
+    // map a file written by write; the header and array sizes are always checked, and with
+    // verify also the checksum, the offsets and the range of every target (reads the whole file)
+    // throw an std::runtime_error exception if the file cannot be opened or mapped
+    // throw an std::invalid_argument exception if the file is not a valid graph file
+    static MappedGraph open(const std::string &path, bool verify = false);
+
+    // the mapped edges; BFS/DFS and the other CsrGraph functions run directly on the file
+    // the mapping stays alive as long as this object or any copy of the CsrGraph does
+    const CsrGraph& graph(void) const;
+
+    int numVertices(void) const;
+
+    long long numEdges(void) const;
+
+    bool hasWeights(void) const;
+
+    // weights of u's out-edges, aligned with graph().neighborsBegin(u), no bounds checking
+    // throw an std::invalid_argument exception if the file has no weights or they are not of type W
+    template <typename W>
+    const W* weightsBegin(int u) const;
+};
+
+#include "MappedGraph.tpp"
@@ -0,0 +1,256 @@
+/*=================================================================================================
+File: MappedGraph.tpp
+Description:
+This file implements the binary graph file format: writing it from a Graph or WeightedGraph, and
+opening it read-only with mmap so the offsets, targets and weights arrays are used in place.
+=================================================================================================*/
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "MappedGraph.hpp"
+
+static_assert(sizeof(int) == 4 && sizeof(long long) == 8, "MappedGraph stores int32 targets and int64 offsets");
+
+/*=================================================================================================
+Constructor: MappedGraph
+Description:
+    Wraps an already validated mapping, see open.
+=================================================================================================*/
+MappedGraph::MappedGraph(CsrGraph csr, const char *weightData, std::uint32_t weightSize, std::uint32_t weightKind)
+    : csr(csr), weightData(weightData), weightSize(weightSize), weightKind(weightKind) {}
+
+/*=================================================================================================
+Function: kindOf
+Description:
+    The header's weight kind code for type W.
+Return:
+    - std::uint32_t: 0 = signed integer, 1 = unsigned integer, 2 = floating point.
+=================================================================================================*/
+template <typename W>
+std::uint32_t MappedGraph::kindOf() {
+    return std::is_floating_point<W>::value ? 2 : std::is_signed<W>::value ? 0 : 1;
+}
+
+/*=================================================================================================
+Function: write
+Description:
+    Writes the header followed by the offsets, targets and (if weightSize is not 0) weights
+    arrays. The arrays are produced straight from the adjacency lists by one routine that
+    feeds a byte sink; it runs once into a FNV-1a hash, so the checksum can go in the header,
+    and once into the stream. No copy of the graph is built.
+Parameters:
+    - const Graph& g: the edges.
+    - std::function<const char*(int)> weightsOf: first byte of u's weights.
+    - std::uint32_t weightSize: bytes per weight, 0 for no weights.
+    - std::uint32_t weightKind: see kindOf.
+    - std::ostream& out: where to write (should be opened in binary mode).
+Return:
+    - nothing
+=================================================================================================*/
+void MappedGraph::write(const Graph &g, std::function<const char*(int)> weightsOf, std::uint32_t weightSize,
+                        std::uint32_t weightKind, std::ostream &out) {
+    int n = g.numVertices();
+    long long m = 0;
+    for (int u = 0; u < n; ++u) {
+        m += g.neighbors(u).size();
+    }
+
+    auto emit = [&](const std::function<void(const char *, size_t)> &sink) {
+        long long offset = 0;
+        sink(reinterpret_cast<const char *>(&offset), sizeof(offset));
+        for (int u = 0; u < n; ++u) {
+            offset += g.neighbors(u).size();
+            sink(reinterpret_cast<const char *>(&offset), sizeof(offset));
+        }
+        for (int u = 0; u < n; ++u) {
+            const std::vector<int> &neighbors = g.neighbors(u);
+            sink(reinterpret_cast<const char *>(neighbors.data()), neighbors.size() * sizeof(int));
+        }
+        if (weightSize != 0) {
+            // the header and offsets are multiples of 8 bytes, so only an odd edge count
+            // leaves the weights misaligned
+            const char padding[4] = {0, 0, 0, 0};
+            sink(padding, m % 2 == 1 ? 4 : 0);
+            for (int u = 0; u < n; ++u) {
+                sink(weightsOf(u), g.neighbors(u).size() * weightSize);
+            }
+        }
+    };
+
+    std::uint64_t checksum = 14695981039346656037ULL; // FNV-1a offset basis
+    emit([&](const char *bytes, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            checksum ^= static_cast<unsigned char>(bytes[i]);
+            checksum *= 1099511628211ULL; // FNV prime
+        }
+    });
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "GRAPHBIN", 8);
+    header.version = 1;
+    header.byteOrder = 0x01020304;
+    header.numVertices = n;
+    header.numEdges = m;
+    header.weightSize = weightSize;
+    header.weightKind = weightKind;
+    header.checksum = checksum;
+
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    emit([&](const char *bytes, size_t count) { out.write(bytes, count); });
+    if (!out) {
+        throw std::runtime_error("MappedGraph: write failed");
+    }
+}
+
+void MappedGraph::write(const Graph &g, std::ostream &out) {
+    write(g, [](int) { return static_cast<const char *>(nullptr); }, 0, 0, out);
+}
+
+template <typename W>
+void MappedGraph::write(const WeightedGraph<W> &g, std::ostream &out) {
+    write(g.topology(), [&](int u) { return reinterpret_cast<const char *>(g.weights(u).data()); }, sizeof(W),
+          kindOf<W>(), out);
+}
+
+/*=================================================================================================
+Function: open
+Description:
+    Maps the whole file read-only and points a CsrGraph at the arrays inside it. Opening only
+    reads the header and two offsets, so it takes the same time for any graph size. The
+    mapping is released when the last copy of the CsrGraph goes away.
+Parameters:
+    - const std::string& path: the file written by write.
+    - bool verify: also check the checksum and the array contents (reads the whole file).
+Return:
+    - MappedGraph: the mapped graph.
+=================================================================================================*/
+MappedGraph MappedGraph::open(const std::string &path, bool verify) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("MappedGraph: cannot open " + path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("MappedGraph: cannot stat " + path);
+    }
+    size_t size = info.st_size;
+    if (size < sizeof(Header)) {
+        ::close(fd);
+        throw std::invalid_argument("MappedGraph: not a graph file");
+    }
+    void *base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // the mapping keeps its own reference to the file
+    if (base == MAP_FAILED) {
+        throw std::runtime_error("MappedGraph: cannot map " + path);
+    }
+    std::shared_ptr<const void> mapping(base, [size](const void *p) { munmap(const_cast<void *>(p), size); });
+    const char *bytes = static_cast<const char *>(base);
+
+    Header header;
+    std::memcpy(&header, bytes, sizeof(header));
+    if (std::memcmp(header.magic, "GRAPHBIN", 8) != 0) {
+        throw std::invalid_argument("MappedGraph: not a graph file");
+    }
+    if (header.version != 1) {
+        throw std::invalid_argument("MappedGraph: unsupported format version");
+    }
+    if (header.byteOrder != 0x01020304) {
+        throw std::invalid_argument("MappedGraph: file was written with a different byte order");
+    }
+    if (header.weightSize != 0 && header.weightSize != 1 && header.weightSize != 2 && header.weightSize != 4 &&
+        header.weightSize != 8) {
+        throw std::invalid_argument("MappedGraph: corrupt header");
+    }
+
+    // sizes are checked against the file length before anything is multiplied out
+    std::uint64_t n = header.numVertices;
+    std::uint64_t m = header.numEdges;
+    std::uint64_t payload = size - sizeof(Header);
+    if (n > INT_MAX || m > payload / sizeof(int) || n + 1 > payload / sizeof(long long)) {
+        throw std::invalid_argument("MappedGraph: file size does not match header");
+    }
+    std::uint64_t targetsAt = sizeof(Header) + (n + 1) * sizeof(long long);
+    std::uint64_t weightsAt = targetsAt + m * sizeof(int) + (header.weightSize != 0 && m % 2 == 1 ? 4 : 0);
+    std::uint64_t expected = header.weightSize == 0 ? targetsAt + m * sizeof(int) : weightsAt + m * header.weightSize;
+    if (expected != size) {
+        throw std::invalid_argument("MappedGraph: file size does not match header");
+    }
+
+    const long long *offsets = reinterpret_cast<const long long *>(bytes + sizeof(Header));
+    const int *targets = reinterpret_cast<const int *>(bytes + targetsAt);
+    if (offsets[0] != 0 || offsets[n] != static_cast<long long>(m)) {
+        throw std::invalid_argument("MappedGraph: corrupt offsets");
+    }
+
+    if (verify) {
+        std::uint64_t checksum = 14695981039346656037ULL;
+        for (size_t i = sizeof(Header); i < size; ++i) {
+            checksum ^= static_cast<unsigned char>(bytes[i]);
+            checksum *= 1099511628211ULL;
+        }
+        if (checksum != header.checksum) {
+            throw std::invalid_argument("MappedGraph: checksum mismatch");
+        }
+        for (std::uint64_t u = 0; u < n; ++u) {
+            if (offsets[u] > offsets[u + 1]) {
+                throw std::invalid_argument("MappedGraph: corrupt offsets");
+            }
+        }
+        for (std::uint64_t i = 0; i < m; ++i) {
+            if (targets[i] < 0 || static_cast<std::uint64_t>(targets[i]) >= n) {
+                throw std::invalid_argument("MappedGraph: corrupt targets");
+            }
+        }
+    }
+
+    CsrGraph csr(mapping, offsets, targets, n, m);
+    return MappedGraph(csr, header.weightSize == 0 ? nullptr : bytes + weightsAt, header.weightSize,
+                       header.weightKind);
+}
+
+/*=================================================================================================
+Function: graph / numVertices / numEdges / hasWeights
+Description:
+    Accessors.
+=================================================================================================*/
+const CsrGraph& MappedGraph::graph() const {
+    return csr;
+}
+
+int MappedGraph::numVertices() const {
+    return csr.numVertices();
+}
+
+long long MappedGraph::numEdges() const {
+    return csr.numEdges();
+}
+
+bool MappedGraph::hasWeights() const {
+    return weightData != nullptr;
+}
+
+/*=================================================================================================
+Function: weightsBegin
+Description:
+    Pointer to u's weights inside the mapped weights array.
+Parameters:
+    - int u: the vertex.
+Return:
+    - const W*: the weight of u's i-th out-edge is at index i.
+=================================================================================================*/
+template <typename W>
+const W* MappedGraph::weightsBegin(int u) const {
+    if (weightData == nullptr) {
+        throw std::invalid_argument("MappedGraph: file has no weights");
+    }
+    if (weightSize != sizeof(W) || weightKind != kindOf<W>()) {
+        throw std::invalid_argument("MappedGraph: weights are not of the requested type");
+    }
+    return reinterpret_cast<const W *>(weightData) + csr.offsets[u];
+}
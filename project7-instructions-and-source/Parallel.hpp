@@ -0,0 +1,157 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// number of threads to use for a requested count
+// numThreads <= 0 means one per hardware thread
+inline int resolveThreadCount(int numThreads) {
+    if (numThreads > 0) {
+        return numThreads;
+    }
+    int hardware = std::thread::hardware_concurrency();
+    return hardware > 0 ? hardware : 1;
+}
+
+// run work(t) for t = 0 ... numThreads - 1 and wait for all of them
+// the calling thread runs t = 0 itself, so numThreads == 1 starts no threads
+// if any call throws, the first exception is rethrown after all threads have finished
+inline void runOnThreads(int numThreads, const std::function<void(int)> &work) {
+    std::vector<std::exception_ptr> errors(numThreads);
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+
+    for (int t = 1; t < numThreads; ++t) {
+        threads.emplace_back([&work, &errors, t]() {
+            try {
+                work(t);
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    try {
+        work(0);
+    } catch (...) {
+        errors[0] = std::current_exception();
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    for (const std::exception_ptr &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+// numThreads - 1 worker threads kept alive across many short parallel rounds (BFS levels,
+// delta-stepping buckets, trim rounds), so a long run of rounds does not start a thread per
+// round; the workers are started by the first run and sleep on a condition variable in between
+class ThreadTeam {
+    private:
+    int numThreads;
+    std::vector<std::thread> threads;
+    std::mutex lock;
+    std::condition_variable started; // a new round, or the team is shutting down
+    std::condition_variable finished; // the last worker finished the round
+    const std::function<void(int)> *current = nullptr; // the work of the current round
+    unsigned long long round = 0; // rounds started so far
+    int remaining = 0; // workers still running the current round
+    bool stopping = false;
+    std::vector<std::exception_ptr> errors;
+
+    void loop(int t) {
+        unsigned long long seen = 0;
+        while (true) {
+            const std::function<void(int)> *job;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                started.wait(guard, [&]() { return round != seen || stopping; });
+                if (stopping) {
+                    return;
+                }
+                seen = round;
+                job = current;
+            }
+            try {
+                (*job)(t);
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+            std::lock_guard<std::mutex> guard(lock);
+            if (--remaining == 0) {
+                finished.notify_one();
+            }
+        }
+    }
+
+    public:
+    // numThreads <= 0 means one per hardware thread
+    explicit ThreadTeam(int requested) : numThreads(resolveThreadCount(requested)), errors(numThreads) {}
+
+    ThreadTeam(const ThreadTeam &) = delete;
+    ThreadTeam& operator=(const ThreadTeam &) = delete;
+
+    ~ThreadTeam() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        started.notify_all();
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+    }
+
+    int size(void) const {
+        return numThreads;
+    }
+
+    // run work(t) for t = 0 ... size() - 1 and wait for all of them, like runOnThreads
+    // the calling thread runs t = 0 itself, so a team of one starts no threads
+    // if any call throws, the first exception is rethrown after all threads have finished the round
+    void run(const std::function<void(int)> &work) {
+        if (numThreads == 1) {
+            work(0);
+            return;
+        }
+        if (threads.empty()) {
+            threads.reserve(numThreads - 1);
+            for (int t = 1; t < numThreads; ++t) {
+                threads.emplace_back([this, t]() { loop(t); });
+            }
+        }
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            current = &work;
+            remaining = numThreads - 1;
+            ++round;
+        }
+        started.notify_all();
+        try {
+            work(0);
+        } catch (...) {
+            errors[0] = std::current_exception();
+        }
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            finished.wait(guard, [&]() { return remaining == 0; });
+        }
+
+        for (std::exception_ptr &error : errors) {
+            if (error) {
+                std::exception_ptr first = error;
+                for (std::exception_ptr &other : errors) {
+                    other = nullptr; // the team stays usable
+                }
+                std::rethrow_exception(first);
+            }
+        }
+    }
+};
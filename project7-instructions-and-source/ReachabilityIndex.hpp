@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+#include "Graph.hpp"
+
+// answers "is there a path from u to v?" with GRAIL-style interval labels
+// the graph is collapsed to its strongly connected components, and every component of the
+// resulting DAG gets numLabels [low, post] intervals from randomized DFS traversals; if v's
+// interval is not inside u's in every labeling, v is not reachable from u (answered in O(1)),
+// otherwise a DFS pruned by the same test decides
+// the index is a snapshot: later changes to the graph are not reflected
+class ReachabilityIndex {
+    private:
+    ComponentResult components; // vertex -> condensation vertex
+    CsrGraph dag; // the condensation
+    int numLabels;
+    std::vector<int> low; // label i of component c is [low[c * numLabels + i], post[c * numLabels + i]]
+    std::vector<int> post;
+
+    // true if every interval of component a contains the matching interval of b
+    bool contains(int a, int b) const;
+
+    public:
+    // throw an std::invalid_argument exception if numLabels < 1
+    ReachabilityIndex(const Graph &g, int numLabels = 3, unsigned seed = 1);
+
+    // true if v is reachable from u (every vertex reaches itself)
+    // safe to call from several threads at once: the fallback search keeps its scratch in
+    // thread_local storage, which stays allocated (one int per component of the largest index
+    // queried) until the thread exits
+    // throw an std::out_of_range exception if u or v is not in the graph
+    bool canReach(int u, int v) const;
+};
+
+#include "ReachabilityIndex.tpp"
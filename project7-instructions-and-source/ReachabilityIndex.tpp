@@ -0,0 +1,174 @@
+/*=================================================================================================
+File: ReachabilityIndex.tpp
+Description:
+This file implements a reachability index based on randomized DFS interval labels (GRAIL),
+built on the strongly connected component condensation of a graph.
+=================================================================================================*/
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include "ReachabilityIndex.hpp"
+
+/*=================================================================================================
+Constructor: ReachabilityIndex
+Description:
+    Condenses the graph into a DAG of strongly connected components and labels it. For each
+    labeling, a DFS starts from the DAG's sources in random order and visits each vertex's
+    children starting at a random offset. A vertex's post is its post-order rank, and its low
+    is the smallest post in everything below it (min of its own post and its children's lows).
+    Anything reachable from c was finished inside c's DFS subtree or earlier subtrees that c
+    reaches, so its interval nests inside c's in every labeling. Different random orders make
+    the labelings disagree on unrelated vertices, which is what lets most negative queries be
+    answered from the labels alone.
+Parameters:
+    - const Graph& g: the graph to index.
+    - int numLabels: number of independent labelings (more = fewer fallback searches).
+    - unsigned seed: seed for the random traversal orders.
+=================================================================================================*/
+ReachabilityIndex::ReachabilityIndex(const Graph &g, int numLabels, unsigned seed)
+    : components(g.stronglyConnectedComponents()), dag(g.condensation(components).freeze()),
+      numLabels(numLabels) {
+    if (numLabels < 1) {
+        throw std::invalid_argument("ReachabilityIndex: need at least one label");
+    }
+    int n = dag.numVertices();
+    low.assign(static_cast<size_t>(n) * numLabels, 0);
+    post.assign(static_cast<size_t>(n) * numLabels, 0);
+
+    // the DFS roots are the components with no incoming edges
+    std::vector<char> hasParent(n, 0);
+    for (int c = 0; c < n; ++c) {
+        for (const int *it = dag.neighborsBegin(c); it != dag.neighborsEnd(c); ++it) {
+            hasParent[*it] = 1;
+        }
+    }
+    std::vector<int> roots;
+    for (int c = 0; c < n; ++c) {
+        if (!hasParent[c]) {
+            roots.push_back(c);
+        }
+    }
+
+    std::mt19937 random(seed);
+    std::vector<char> visited(n);
+    std::vector<unsigned> offset(n); // where each vertex starts looking at its children
+    // (vertex, children looked at so far)
+    std::vector<std::pair<int, unsigned> > dfs;
+
+    for (int label = 0; label < numLabels; ++label) {
+        std::shuffle(roots.begin(), roots.end(), random);
+        std::fill(visited.begin(), visited.end(), 0);
+        int rank = 0;
+
+        for (int root : roots) {
+            visited[root] = 1;
+            offset[root] = random();
+            dfs.push_back(std::make_pair(root, 0u));
+            while (!dfs.empty()) {
+                int c = dfs.back().first;
+                unsigned degree = dag.neighborsEnd(c) - dag.neighborsBegin(c);
+                if (dfs.back().second < degree) {
+                    // next child, in rotated order
+                    int child = dag.neighborsBegin(c)[(offset[c] % degree + dfs.back().second) % degree];
+                    ++dfs.back().second;
+                    if (!visited[child]) {
+                        visited[child] = 1;
+                        offset[child] = random();
+                        dfs.push_back(std::make_pair(child, 0u));
+                    }
+                    continue;
+                }
+
+                // c finishes: all its children are labeled by now
+                dfs.pop_back();
+                size_t at = static_cast<size_t>(c) * numLabels + label;
+                post[at] = ++rank;
+                low[at] = rank;
+                for (const int *it = dag.neighborsBegin(c); it != dag.neighborsEnd(c); ++it) {
+                    low[at] = std::min(low[at], low[static_cast<size_t>(*it) * numLabels + label]);
+                }
+            }
+        }
+    }
+}
+
+/*=================================================================================================
+Function: contains
+Description:
+    Interval containment test in every labeling. If it fails, b cannot be reachable from a.
+Parameters:
+    - int a, int b: condensation vertices.
+Return:
+    - bool: true if all of b's intervals are inside a's.
+=================================================================================================*/
+bool ReachabilityIndex::contains(int a, int b) const {
+    size_t x = static_cast<size_t>(a) * numLabels;
+    size_t y = static_cast<size_t>(b) * numLabels;
+    for (int i = 0; i < numLabels; ++i) {
+        if (low[x + i] > low[y + i] || post[y + i] > post[x + i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*=================================================================================================
+Function: canReach
+Description:
+    Vertices in the same strongly connected component always reach each other. Otherwise the
+    labels rule out most unreachable pairs immediately. What is left is decided by a DFS over
+    the condensation that only enters components whose labels still contain v's, so it
+    rarely strays far from the answer. The search's marks and stack are thread_local and
+    epoch-stamped, so queries do not clear them and concurrent queries do not share them; the
+    epoch only grows, so marks left by another index on this thread never look current.
+Parameters:
+    - int u: the start vertex.
+    - int v: the target vertex.
+Return:
+    - bool: true if there is a path from u to v.
+=================================================================================================*/
+bool ReachabilityIndex::canReach(int u, int v) const {
+    int n = components.component.size();
+    if (u < 0 || u >= n || v < 0 || v >= n) {
+        throw std::out_of_range("canReach: vertex index out of range");
+    }
+    int from = components.component[u];
+    int to = components.component[v];
+    if (from == to) {
+        return true;
+    }
+    if (!contains(from, to)) {
+        return false;
+    }
+
+    static thread_local std::vector<unsigned> stamp;
+    static thread_local unsigned epoch = 0;
+    static thread_local std::vector<int> stack;
+    if (stamp.size() < static_cast<size_t>(dag.numVertices())) {
+        stamp.resize(dag.numVertices(), 0);
+    }
+
+    // new epoch instead of clearing the marks
+    if (++epoch == 0) {
+        std::fill(stamp.begin(), stamp.end(), 0);
+        epoch = 1;
+    }
+    stack.clear();
+    stack.push_back(from);
+    stamp[from] = epoch;
+    while (!stack.empty()) {
+        int c = stack.back();
+        stack.pop_back();
+        for (const int *it = dag.neighborsBegin(c); it != dag.neighborsEnd(c); ++it) {
+            int child = *it;
+            if (child == to) {
+                return true;
+            }
+            if (stamp[child] != epoch && contains(child, to)) {
+                stamp[child] = epoch;
+                stack.push_back(child);
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include "Graph.hpp"
+
+// per-vertex result of a weighted shortest path search, the weighted counterpart of the BFS
+// fields of TraversalData
+// distance is numeric_limits<W>::max() and parent -1 for vertices that were not reached
+template <typename W>
+struct WeightedTraversalData {
+    bool visited;
+    int parent;
+    W distance;
+};
+
+// result of WeightedGraph::criticalPath
+template <typename W>
+struct CriticalPath {
+    W length; // total weight of the path
+    std::vector<int> path; // vertices from the start of the path to its end
+};
+
+// min-heap of vertices keyed by W, with a position index so a vertex's key can be lowered in
+// place (decrease-key); each node has D children, which keeps the tree shallow and the
+// children of a node next to each other in memory
+template <typename W, int D = 4>
+class IndexedHeap {
+    private:
+    std::vector<int> heap; // vertices in heap order
+    std::vector<W> key; // key of each vertex
+    std::vector<int> position; // index of each vertex in heap, -1 if not in it
+
+    void siftUp(int i);
+    void siftDown(int i);
+
+    public:
+    // a heap for vertices 0 ... n-1
+    IndexedHeap(int n);
+
+    bool empty(void) const;
+
+    bool contains(int v) const;
+
+    // insert v with key k, or lower v's key to k if it is already in the heap with a larger key
+    void pushOrDecrease(int v, W k);
+
+    // remove and return the vertex with the smallest key
+    int pop(void);
+};
+
+// directed graph with a weight of type W on every edge
+// the topology is an ordinary Graph (same no-duplicate-edges rule, same neighbor order), and the
+// weights are kept in lists aligned with its adjacency lists
+template <typename W>
+class WeightedGraph {
+    static_assert(std::is_arithmetic<W>::value, "edge weights must be a number type");
+
+    private:
+    Graph graph;
+    std::vector<std::vector<W> > weightList; // weightList[u][i] belongs to edge (u, graph.neighbors(u)[i])
+
+    // index of v in u's neighbor list, -1 if (u, v) is not an edge
+    int position(int u, int v) const;
+
+    // shared body of the DAG path functions: one pass over the topological levels where each
+    // vertex takes the best (smallest or largest) distance offered by its in-edges
+    // s == -1 starts a path at every vertex with distance 0
+    std::vector<WeightedTraversalData<W> > dagPaths(int s, bool longest, int numThreads) const;
+
+    public:
+    WeightedGraph(int n);
+
+    // graph with edges[i] weighted weights[i], built in bulk like Graph::fromEdges (numThreads
+    // as there); a repeated edge keeps its first position and its last weight, the same graph
+    // addEdge would build
+    // throw an std::invalid_argument exception if n < 0 or the two arrays differ in length
+    // throw an std::out_of_range exception if an edge uses a vertex that is not in the graph
+    static WeightedGraph fromEdges(int n, const std::vector<std::pair<int, int> > &edges,
+                                   const std::vector<W> &weights, int numThreads = 0);
+
+    // DIMACS shortest path file ("c" comments, "p sp n m", then m "a u v w" arcs with 1-based
+    // vertices and integer weights), streamed and built with fromEdges
+    // throw an std::invalid_argument exception if the input is malformed
+    // throw an std::out_of_range exception if an arc uses a vertex outside the declared size, or
+    // has a weight that an integer W cannot hold
+    static WeightedGraph readDIMACS(std::istream &in, int numThreads = 0);
+
+    int numVertices(void) const;
+
+    // return true if u is in the graph, false otherwise
+    bool vertexIn(int u) const;
+
+    // throw an std::out_of_range exception if u or v is not in the graph
+    bool edgeIn(int u, int v) const;
+
+    // add the edge (u, v), or change its weight if it already exists
+    // throw an std::out_of_range exception if u or v is not in the graph
+    void addEdge(int u, int v, W weight);
+
+    // throw an std::out_of_range exception if u or v is not in the graph
+    // throw an std::out_of_range exception if (u, v) is not an edge of the graph
+    W weight(int u, int v) const;
+
+    // throw an std::out_of_range exception if u or v is not in the graph
+    // throw an std::out_of_range exception if (u, v) is not an edge of the graph
+    void removeEdge(int u, int v);
+
+    // the edges without their weights, for the unweighted algorithms
+    const Graph& topology(void) const;
+
+    // weights of u's out-edges, aligned with topology().neighbors(u)
+    // throw an std::out_of_range exception if u is not in the graph
+    const std::vector<W>& weights(int u) const;
+
+    // single-source shortest paths with Dijkstra's algorithm on a 4-ary indexed heap
+    // throw an std::out_of_range exception if s is not in graph
+    // throw an std::invalid_argument exception if a reachable edge has a negative weight
+    std::vector<WeightedTraversalData<W> > dijkstra(int s) const;
+
+    // single-source shortest paths with parallel delta-stepping: vertices are grouped into
+    // buckets of width delta and each bucket is relaxed by numThreads threads (<= 0 uses all
+    // hardware threads); distances match dijkstra (exactly for integer weights)
+    // throw an std::out_of_range exception if s is not in graph
+    // throw an std::invalid_argument exception if delta <= 0 or an edge has a negative weight
+    std::vector<WeightedTraversalData<W> > deltaStepping(int s, W delta, int numThreads = 0) const;
+
+    // single-source shortest / longest paths on a DAG in one linear pass over the topological
+    // levels, each level processed across numThreads threads (<= 0 uses all hardware threads)
+    // negative weights are allowed
+    // throw an std::out_of_range exception if s is not in graph
+    // throw an std::invalid_argument exception if the graph has a cycle
+    std::vector<WeightedTraversalData<W> > dagShortestPaths(int s, int numThreads = 0) const;
+    std::vector<WeightedTraversalData<W> > dagLongestPaths(int s, int numThreads = 0) const;
+
+    // heaviest path anywhere in the DAG (critical path analysis); a single vertex with no
+    // edges is a path of length 0
+    // throw an std::invalid_argument exception if the graph has a cycle
+    CriticalPath<W> criticalPath(int numThreads = 0) const;
+};
+
+#include "WeightedGraph.tpp"
@@ -0,0 +1,772 @@
+/*=================================================================================================
+File: WeightedGraph.tpp
+Description:
+This file implements a directed graph with weighted edges on top of Graph, an indexed d-ary heap,
+Dijkstra's single-source shortest path algorithm, parallel delta-stepping, and DAG shortest,
+longest and critical path computations.
+=================================================================================================*/
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include "WeightedGraph.hpp"
+
+/*=================================================================================================
+Constructor: IndexedHeap
+Description:
+    Creates an empty heap able to hold vertices 0 ... n-1.
+Parameters:
+    - int n: number of vertices.
+=================================================================================================*/
+template <typename W, int D>
+IndexedHeap<W, D>::IndexedHeap(int n) : key(n), position(n, -1) {}
+
+/*=================================================================================================
+Function: empty / contains
+Description:
+    Whether the heap has any vertices / whether v is currently in it.
+=================================================================================================*/
+template <typename W, int D>
+bool IndexedHeap<W, D>::empty() const {
+    return heap.empty();
+}
+
+template <typename W, int D>
+bool IndexedHeap<W, D>::contains(int v) const {
+    return position[v] != -1;
+}
+
+/*=================================================================================================
+Function: pushOrDecrease
+Description:
+    Inserts v at the bottom, or lowers its key where it is, and sifts it up to its place.
+Parameters:
+    - int v: the vertex.
+    - W k: its new key.
+Return:
+    - nothing
+=================================================================================================*/
+template <typename W, int D>
+void IndexedHeap<W, D>::pushOrDecrease(int v, W k) {
+    if (position[v] == -1) {
+        position[v] = heap.size();
+        heap.push_back(v);
+    } else if (!(k < key[v])) {
+        return; // not an improvement
+    }
+    key[v] = k;
+    siftUp(position[v]);
+}
+
+/*=================================================================================================
+Function: pop
+Description:
+    Removes the root, moves the last vertex to the root and sifts it down.
+Parameters:
+    - none
+Return:
+    - int: the vertex with the smallest key.
+=================================================================================================*/
+template <typename W, int D>
+int IndexedHeap<W, D>::pop() {
+    int top = heap[0];
+    position[top] = -1;
+    int last = heap.back();
+    heap.pop_back();
+    if (!heap.empty()) {
+        heap[0] = last;
+        position[last] = 0;
+        siftDown(0);
+    }
+    return top;
+}
+
+/*=================================================================================================
+Function: siftUp / siftDown
+Description:
+    Restore the heap order by moving the vertex at index i towards the root / the leaves.
+    The moving vertex is held aside and the others are shifted past it, writing it once at the
+    end instead of swapping at every step.
+Parameters:
+    - int i: index in heap.
+Return:
+    - nothing
+=================================================================================================*/
+template <typename W, int D>
+void IndexedHeap<W, D>::siftUp(int i) {
+    int v = heap[i];
+    while (i > 0) {
+        int parent = (i - 1) / D;
+        if (!(key[v] < key[heap[parent]])) {
+            break;
+        }
+        heap[i] = heap[parent];
+        position[heap[i]] = i;
+        i = parent;
+    }
+    heap[i] = v;
+    position[v] = i;
+}
+
+template <typename W, int D>
+void IndexedHeap<W, D>::siftDown(int i) {
+    int v = heap[i];
+    int size = heap.size();
+    while (true) {
+        int first = D * i + 1;
+        if (first >= size) {
+            break;
+        }
+        // smallest of the (up to D) children
+        int best = first;
+        int end = std::min(first + D, size);
+        for (int c = first + 1; c < end; ++c) {
+            if (key[heap[c]] < key[heap[best]]) {
+                best = c;
+            }
+        }
+        if (!(key[heap[best]] < key[v])) {
+            break;
+        }
+        heap[i] = heap[best];
+        position[heap[i]] = i;
+        i = best;
+    }
+    heap[i] = v;
+    position[v] = i;
+}
+
+/*=================================================================================================
+Constructor: WeightedGraph
+Description:
+    Initializes a weighted directed graph with n vertices and no edges.
+Parameters:
+    - int n: the number of vertices in the graph.
+=================================================================================================*/
+template <typename W>
+WeightedGraph<W>::WeightedGraph(int n) : graph(n), weightList(n) {}
+
+/*=================================================================================================
+Function: fromEdges
+Description:
+    Builds the topology with Graph::fromEdgeBlocks, which also reports where every input edge
+    ended up in its source's neighbor list. Writing the weights through those slots in input
+    order lets a later copy of an edge overwrite the weight of an earlier one, as addEdge does.
+Parameters:
+    - int n: number of vertices.
+    - const std::vector<std::pair<int, int>>& edges: the (u, v) edges in insertion order.
+    - const std::vector<W>& weights: weights[i] belongs to edges[i].
+    - int numThreads: number of threads, <= 0 for one per hardware thread.
+Return:
+    - WeightedGraph: the graph with those edges.
+=================================================================================================*/
+template <typename W>
+WeightedGraph<W> WeightedGraph<W>::fromEdges(int n, const std::vector<std::pair<int, int> > &edges,
+                                             const std::vector<W> &weights, int numThreads) {
+    if (n < 0) {
+        throw std::invalid_argument("fromEdges: negative vertex count");
+    }
+    if (weights.size() != edges.size()) {
+        throw std::invalid_argument("fromEdges: expected one weight per edge");
+    }
+
+    std::vector<int> placement;
+    Graph built = Graph::fromEdgeBlocks(n, &edges, 1, numThreads, &placement);
+
+    WeightedGraph<W> g(n);
+    g.graph.adjList.swap(built.adjList);
+    for (int u = 0; u < n; ++u) {
+        g.weightList[u].resize(g.graph.adjList[u].size());
+    }
+    for (size_t i = 0; i < edges.size(); ++i) {
+        g.weightList[edges[i].first][placement[i]] = weights[i];
+    }
+    return g;
+}
+
+/*=================================================================================================
+Function: readDIMACS
+Description:
+    Reads a DIMACS shortest path challenge file. Lines starting with 'c' and blank lines are
+    skipped, the "p sp n m" line must come before the arcs, and the number of arcs must match
+    m. Weights are read as 64-bit integers and converted to W; an integer W must hold the
+    weight exactly (any 64-bit integer converts to a floating-point W, possibly rounded).
+Parameters:
+    - std::istream& in: the stream to read.
+    - int numThreads: threads for fromEdges.
+Return:
+    - WeightedGraph: the graph.
+=================================================================================================*/
+template <typename W>
+WeightedGraph<W> WeightedGraph<W>::readDIMACS(std::istream &in, int numThreads) {
+    std::vector<std::pair<int, int> > edges;
+    std::vector<W> weights;
+    long long n = -1, m = -1;
+
+    Graph::forEachLine(in, [&](long long line, const char *p, const char *end) {
+        auto where = [&]() { return "readDIMACS: line " + std::to_string(line) + ": "; };
+        while (p != end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+            ++p;
+        }
+        if (p == end || *p == 'c') {
+            return; // blank or comment
+        }
+
+        char kind = *p++;
+        if (kind == 'p') {
+            while (p != end && (*p == ' ' || *p == '\t')) {
+                ++p;
+            }
+            if (n >= 0 || end - p < 2 || p[0] != 's' || p[1] != 'p') {
+                throw std::invalid_argument(where() + "expected a single \"p sp n m\" line");
+            }
+            p += 2;
+            if (!Graph::nextInteger(p, end, n) || !Graph::nextInteger(p, end, m) || n < 0 || m < 0 ||
+                n > std::numeric_limits<int>::max()) {
+                throw std::invalid_argument(where() + "expected \"p sp n m\"");
+            }
+            edges.reserve(std::min<long long>(m, 1 << 24));
+            weights.reserve(std::min<long long>(m, 1 << 24));
+        } else if (kind == 'a') {
+            long long u, v, w;
+            if (n < 0) {
+                throw std::invalid_argument(where() + "arc before the \"p sp n m\" line");
+            }
+            if (!Graph::nextInteger(p, end, u) || !Graph::nextInteger(p, end, v) || !Graph::nextInteger(p, end, w)) {
+                throw std::invalid_argument(where() + "expected \"a u v w\"");
+            }
+            if (u < 1 || u > n || v < 1 || v > n) {
+                throw std::out_of_range(where() + "arc endpoint outside the graph");
+            }
+            bool fits = true;
+            if constexpr (std::is_integral<W>::value && std::is_signed<W>::value) {
+                fits = w >= static_cast<long long>(std::numeric_limits<W>::min()) &&
+                       w <= static_cast<long long>(std::numeric_limits<W>::max());
+            } else if constexpr (std::is_integral<W>::value) {
+                fits = w >= 0 &&
+                       static_cast<unsigned long long>(w) <= static_cast<unsigned long long>(std::numeric_limits<W>::max());
+            }
+            if (!fits) {
+                throw std::out_of_range(where() + "arc weight does not fit the weight type");
+            }
+            edges.push_back(std::make_pair(static_cast<int>(u - 1), static_cast<int>(v - 1)));
+            weights.push_back(static_cast<W>(w));
+        } else {
+            throw std::invalid_argument(where() + "unknown line type '" + std::string(1, kind) + "'");
+        }
+    });
+
+    if (n < 0) {
+        throw std::invalid_argument("readDIMACS: missing \"p sp n m\" line");
+    }
+    if (static_cast<long long>(edges.size()) != m) {
+        throw std::invalid_argument("readDIMACS: expected " + std::to_string(m) + " arcs, got " +
+                                    std::to_string(edges.size()));
+    }
+    return fromEdges(n, edges, weights, numThreads);
+}
+
+/*=================================================================================================
+Function: numVertices / vertexIn / edgeIn / topology
+Description:
+    Forwarded to the underlying Graph.
+=================================================================================================*/
+template <typename W>
+int WeightedGraph<W>::numVertices() const {
+    return graph.numVertices();
+}
+
+template <typename W>
+bool WeightedGraph<W>::vertexIn(int u) const {
+    return graph.vertexIn(u);
+}
+
+template <typename W>
+bool WeightedGraph<W>::edgeIn(int u, int v) const {
+    return graph.edgeIn(u, v);
+}
+
+template <typename W>
+const Graph& WeightedGraph<W>::topology() const {
+    return graph;
+}
+
+/*=================================================================================================
+Function: weights
+Description:
+    The weights of u's out-edges, in the same order as topology().neighbors(u).
+Parameters:
+    - int u: the vertex.
+Return:
+    - const std::vector<W>&: the weights.
+=================================================================================================*/
+template <typename W>
+const std::vector<W>& WeightedGraph<W>::weights(int u) const {
+    if (!vertexIn(u)) {
+        throw std::out_of_range("weights: vertex index out of range");
+    }
+    return weightList[u];
+}
+
+/*=================================================================================================
+Function: position
+Description:
+    Finds where v sits in u's neighbor list, which is also where its weight is stored.
+Parameters:
+    - int u: the source vertex.
+    - int v: the target vertex.
+Return:
+    - int: the index, or -1 if (u, v) is not an edge.
+=================================================================================================*/
+template <typename W>
+int WeightedGraph<W>::position(int u, int v) const {
+    const std::vector<int> &neighbors = graph.neighbors(u);
+    for (size_t i = 0; i < neighbors.size(); ++i) {
+        if (neighbors[i] == v) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/*=================================================================================================
+Function: addEdge
+Description:
+    Adds the edge (u, v) with the given weight. Graph::addEdge appends new edges at the end of
+    u's list, so the weight is appended too. If the edge already exists its weight is replaced.
+Parameters:
+    - int u: the source vertex.
+    - int v: the destination vertex.
+    - W weight: the edge weight.
+Return:
+    - nothing
+=================================================================================================*/
+template <typename W>
+void WeightedGraph<W>::addEdge(int u, int v, W weight) {
+    if (!vertexIn(u) || !vertexIn(v)) {
+        throw std::out_of_range("addEdge: vertex index out of range");
+    }
+    if (graph.edgeIn(u, v)) {
+        weightList[u][position(u, v)] = weight;
+    } else {
+        graph.addEdge(u, v);
+        weightList[u].push_back(weight);
+    }
+}
+
+/*=================================================================================================
+Function: weight
+Description:
+    Looks up the weight of the edge (u, v).
+Parameters:
+    - int u: the source vertex.
+    - int v: the destination vertex.
+Return:
+    - W: the weight.
+=================================================================================================*/
+template <typename W>
+W WeightedGraph<W>::weight(int u, int v) const {
+    if (!vertexIn(u) || !vertexIn(v)) {
+        throw std::out_of_range("weight: vertex index out of range");
+    }
+    int i = position(u, v);
+    if (i == -1) {
+        throw std::out_of_range("weight: edge does not exist");
+    }
+    return weightList[u][i];
+}
+
+/*=================================================================================================
+Function: removeEdge
+Description:
+    Removes the edge (u, v) and its weight. Graph::removeEdge keeps the other neighbors in
+    order, so erasing the weight at the same index keeps the lists aligned.
+Parameters:
+    - int u: the source vertex.
+    - int v: the destination vertex.
+Return:
+    - nothing
+=================================================================================================*/
+template <typename W>
+void WeightedGraph<W>::removeEdge(int u, int v) {
+    if (!vertexIn(u) || !vertexIn(v)) {
+        throw std::out_of_range("removeEdge: vertex index out of range");
+    }
+    int i = position(u, v);
+    if (i == -1) {
+        throw std::out_of_range("removeEdge: edge does not exist");
+    }
+    graph.removeEdge(u, v);
+    weightList[u].erase(weightList[u].begin() + i);
+}
+
+/*=================================================================================================
+Function: dijkstra
+Description:
+    Dijkstra's algorithm. The frontier is an indexed 4-ary heap, so relaxing an edge lowers the
+    target's key in place (decrease-key) rather than pushing a duplicate entry, and the heap
+    never holds more than n vertices. Once a vertex is popped its distance is final.
+Parameters:
+    - int s: the source vertex.
+Return:
+    - std::vector<WeightedTraversalData<W>>: visited status, parent, and distance from s for
+      each vertex.
+=================================================================================================*/
+template <typename W>
+std::vector<WeightedTraversalData<W> > WeightedGraph<W>::dijkstra(int s) const {
+    if (!vertexIn(s)) {
+        throw std::out_of_range("dijkstra: source not in graph");
+    }
+    int n = numVertices();
+    std::vector<WeightedTraversalData<W> > data(n);
+    for (int i = 0; i < n; ++i) {
+        data[i].visited = false;
+        data[i].parent = -1;
+        data[i].distance = std::numeric_limits<W>::max();
+    }
+
+    IndexedHeap<W> heap(n);
+    data[s].distance = 0;
+    heap.pushOrDecrease(s, 0);
+
+    while (!heap.empty()) {
+        int u = heap.pop();
+        data[u].visited = true; // distance is final now
+
+        const std::vector<int> &neighbors = graph.neighbors(u);
+        const std::vector<W> &w = weightList[u];
+        for (size_t i = 0; i < neighbors.size(); ++i) {
+            if (w[i] < 0) {
+                throw std::invalid_argument("dijkstra: negative edge weight");
+            }
+            int v = neighbors[i];
+            W candidate = data[u].distance + w[i];
+            if (!data[v].visited && candidate < data[v].distance) {
+                data[v].distance = candidate;
+                data[v].parent = u;
+                heap.pushOrDecrease(v, candidate);
+            }
+        }
+    }
+    return data;
+}
+
+/*=================================================================================================
+Function: deltaStepping
+Description:
+    Delta-stepping (Meyer, Sanders). Tentative distances live in atomics and are only ever
+    lowered with a compare-exchange loop, so threads can relax edges concurrently. Vertices sit
+    in bucket floor(distance / delta), and buckets are settled in increasing order:
+      - edges with weight <= delta (light) can put a vertex back into the current bucket, so
+        the bucket is relaxed repeatedly until it stays empty
+      - heavy edges always land in a later bucket, so they are relaxed once at the end, from
+        every vertex the bucket settled
+    Each relaxation round splits its vertices across the threads of one ThreadTeam, started
+    once per call, so refilled buckets and heavy passes do not start threads per round;
+    rounds under MIN_PARALLEL vertices run on the calling thread. Every successful relaxation
+    is logged as (v, u, new distance) in a per-thread list, and the lists are then sorted into
+    buckets. A vertex may sit in several buckets after being improved; only the copy matching
+    its current distance is processed.
+    Parents are recorded while merging the lists: the entry whose distance is the one v ended
+    the round with is the relaxation that stored it, so its u becomes v's parent. This compares
+    a value with itself, so it also holds for floating-point weights. Every parent change comes
+    from a strict improvement, so the parents form a tree, even with zero-weight cycles.
+Parameters:
+    - int s: the source vertex.
+    - W delta: the bucket width; small values approach Dijkstra, large values Bellman-Ford.
+    - int numThreads: number of threads, <= 0 for one per hardware thread.
+Return:
+    - std::vector<WeightedTraversalData<W>>: visited status, parent, and distance from s for
+      each vertex.
+=================================================================================================*/
+template <typename W>
+std::vector<WeightedTraversalData<W> > WeightedGraph<W>::deltaStepping(int s, W delta, int numThreads) const {
+    const size_t CHUNK = 64; // vertices taken per grab
+    const size_t MIN_PARALLEL = 1024; // smaller rounds are not worth waking threads for
+    const W INF = std::numeric_limits<W>::max();
+
+    if (!vertexIn(s)) {
+        throw std::out_of_range("deltaStepping: source not in graph");
+    }
+    if (!(delta > 0)) {
+        throw std::invalid_argument("deltaStepping: delta must be positive");
+    }
+    int n = numVertices();
+    for (int u = 0; u < n; ++u) {
+        for (W w : weightList[u]) {
+            if (w < 0) {
+                throw std::invalid_argument("deltaStepping: negative edge weight");
+            }
+        }
+    }
+    numThreads = resolveThreadCount(numThreads);
+
+    std::vector<std::atomic<W> > dist(n);
+    for (int v = 0; v < n; ++v) {
+        dist[v].store(INF, std::memory_order_relaxed);
+    }
+    dist[s].store(0, std::memory_order_relaxed);
+
+    struct Relaxation {
+        int v;
+        int u;
+        W distance;
+    };
+
+    auto bucketOf = [&](W d) { return static_cast<long long>(d / delta); };
+    std::map<long long, std::vector<int> > buckets;
+    buckets[0].push_back(s);
+    std::vector<int> parent(n, -1);
+    std::vector<std::vector<Relaxation> > relaxed(numThreads); // per-thread successful relaxations
+    std::vector<int> settled; // vertices taken out of the current bucket
+    std::vector<char> inSettled(n, 0);
+
+    ThreadTeam team(numThreads);
+
+    // relax the light or heavy out-edges of every vertex in list, in parallel
+    auto relaxAll = [&](const std::vector<int> &list, bool light) {
+        std::atomic<size_t> cursor(0);
+        auto relax = [&](int t) {
+            size_t begin;
+            while ((begin = cursor.fetch_add(CHUNK, std::memory_order_relaxed)) < list.size()) {
+                size_t end = std::min(begin + CHUNK, list.size());
+                for (size_t i = begin; i < end; ++i) {
+                    int u = list[i];
+                    W du = dist[u].load(std::memory_order_relaxed);
+                    const std::vector<int> &neighbors = graph.neighbors(u);
+                    const std::vector<W> &w = weightList[u];
+                    for (size_t j = 0; j < neighbors.size(); ++j) {
+                        if ((w[j] <= delta) != light) {
+                            continue;
+                        }
+                        int v = neighbors[j];
+                        W candidate = du + w[j];
+                        W current = dist[v].load(std::memory_order_relaxed);
+                        while (candidate < current) {
+                            if (dist[v].compare_exchange_weak(current, candidate, std::memory_order_relaxed)) {
+                                relaxed[t].push_back(Relaxation{v, u, candidate});
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+        };
+        if (list.size() < MIN_PARALLEL) {
+            relax(0);
+        } else {
+            team.run(relax);
+        }
+
+        // file the improved vertices under their new buckets, keeping the parent that set the
+        // distance each one ended the round with
+        for (std::vector<Relaxation> &improved : relaxed) {
+            for (const Relaxation &r : improved) {
+                if (r.distance == dist[r.v].load(std::memory_order_relaxed)) {
+                    parent[r.v] = r.u;
+                    buckets[bucketOf(r.distance)].push_back(r.v);
+                }
+            }
+            improved.clear();
+        }
+    };
+
+    while (!buckets.empty()) {
+        long long index = buckets.begin()->first;
+        settled.clear();
+
+        // light edges until the bucket stops refilling
+        while (buckets.count(index)) {
+            std::vector<int> current;
+            current.swap(buckets[index]);
+            buckets.erase(index);
+
+            // skip stale copies (the vertex has since moved to an earlier bucket) and repeats
+            std::vector<int> active;
+            for (int v : current) {
+                if (bucketOf(dist[v].load(std::memory_order_relaxed)) == index) {
+                    active.push_back(v);
+                    if (!inSettled[v]) {
+                        inSettled[v] = 1;
+                        settled.push_back(v);
+                    }
+                }
+            }
+            std::sort(active.begin(), active.end());
+            active.erase(std::unique(active.begin(), active.end()), active.end());
+            relaxAll(active, true);
+        }
+
+        // heavy edges once, from everything the bucket settled
+        relaxAll(settled, false);
+        for (int v : settled) {
+            inSettled[v] = 0;
+        }
+    }
+
+    std::vector<WeightedTraversalData<W> > data(n);
+    for (int v = 0; v < n; ++v) {
+        data[v].distance = dist[v].load(std::memory_order_relaxed);
+        data[v].visited = data[v].distance != INF;
+        data[v].parent = parent[v];
+    }
+    return data;
+}
+
+/*=================================================================================================
+Function: dagPaths
+Description:
+    Path distances on a DAG from its topological levels (Graph::topologicalLevels). Every
+    in-neighbor of a vertex is in an earlier level, so by the time a level is processed all its
+    inputs are final. Each vertex pulls from its in-edges (stored as a reversed CSR with
+    weights, built once per call) and keeps the best distance, ties going to the first
+    in-neighbor by vertex number. Vertices of one level only write their own entries, so a
+    level can be split across threads without any synchronization beyond the level barrier.
+    One ThreadTeam computes the levels and then runs every wide level, so the whole call starts
+    its threads once.
+Parameters:
+    - int s: the source vertex, or -1 to let a path start at any vertex.
+    - bool longest: maximize instead of minimize.
+    - int numThreads: number of threads, <= 0 for one per hardware thread.
+Return:
+    - std::vector<WeightedTraversalData<W>>: visited status, parent, and distance for each vertex.
+=================================================================================================*/
+template <typename W>
+std::vector<WeightedTraversalData<W> > WeightedGraph<W>::dagPaths(int s, bool longest, int numThreads) const {
+    const size_t CHUNK = 64; // vertices taken per grab
+    const size_t MIN_PARALLEL = 1024; // smaller levels are not worth waking threads for
+
+    int n = numVertices();
+    ThreadTeam team(numThreads);
+    std::vector<std::vector<int> > levels = graph.topologicalLevels(team); // throws on a cycle
+
+    // reversed edges with their weights, sources in increasing order
+    std::vector<long long> offsets(n + 1, 0);
+    for (int u = 0; u < n; ++u) {
+        for (int v : graph.neighbors(u)) {
+            ++offsets[v + 1];
+        }
+    }
+    for (int v = 0; v < n; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+    std::vector<int> sources(offsets[n]);
+    std::vector<W> inWeight(offsets[n]);
+    std::vector<long long> fill(offsets.begin(), offsets.end() - 1);
+    for (int u = 0; u < n; ++u) {
+        const std::vector<int> &neighbors = graph.neighbors(u);
+        for (size_t j = 0; j < neighbors.size(); ++j) {
+            long long at = fill[neighbors[j]]++;
+            sources[at] = u;
+            inWeight[at] = weightList[u][j];
+        }
+    }
+
+    std::vector<WeightedTraversalData<W> > data(n);
+    for (int v = 0; v < n; ++v) {
+        data[v].visited = s == -1;
+        data[v].parent = -1;
+        data[v].distance = s == -1 ? W(0) : std::numeric_limits<W>::max();
+    }
+    if (s != -1) {
+        data[s].visited = true;
+        data[s].distance = 0;
+    }
+
+    for (const std::vector<int> &level : levels) {
+        std::atomic<size_t> cursor(0);
+        auto pull = [&](int) {
+            size_t begin;
+            while ((begin = cursor.fetch_add(CHUNK, std::memory_order_relaxed)) < level.size()) {
+                size_t end = std::min(begin + CHUNK, level.size());
+                for (size_t i = begin; i < end; ++i) {
+                    int v = level[i];
+                    if (v == s) {
+                        continue; // the source keeps distance 0
+                    }
+                    WeightedTraversalData<W> &d = data[v];
+                    for (long long e = offsets[v]; e < offsets[v + 1]; ++e) {
+                        const WeightedTraversalData<W> &from = data[sources[e]];
+                        if (!from.visited) {
+                            continue;
+                        }
+                        W candidate = from.distance + inWeight[e];
+                        bool better = longest ? candidate > d.distance : candidate < d.distance;
+                        // the first edge to reach v wins even when it does not beat 0 / INF
+                        if (better || (s != -1 && !d.visited)) {
+                            d.distance = candidate;
+                            d.parent = sources[e];
+                            d.visited = true;
+                        }
+                    }
+                }
+            }
+        };
+        if (level.size() < MIN_PARALLEL) {
+            pull(0);
+        } else {
+            team.run(pull);
+        }
+    }
+    return data;
+}
+
+/*=================================================================================================
+Function: dagShortestPaths / dagLongestPaths
+Description:
+    Single-source DAG shortest and longest paths, see dagPaths.
+Parameters:
+    - int s: the source vertex.
+    - int numThreads: number of threads, <= 0 for one per hardware thread.
+Return:
+    - std::vector<WeightedTraversalData<W>>: visited status, parent, and distance from s for
+      each vertex.
+=================================================================================================*/
+template <typename W>
+std::vector<WeightedTraversalData<W> > WeightedGraph<W>::dagShortestPaths(int s, int numThreads) const {
+    if (!vertexIn(s)) {
+        throw std::out_of_range("dagShortestPaths: source not in graph");
+    }
+    return dagPaths(s, false, numThreads);
+}
+
+template <typename W>
+std::vector<WeightedTraversalData<W> > WeightedGraph<W>::dagLongestPaths(int s, int numThreads) const {
+    if (!vertexIn(s)) {
+        throw std::out_of_range("dagLongestPaths: source not in graph");
+    }
+    return dagPaths(s, true, numThreads);
+}
+
+/*=================================================================================================
+Function: criticalPath
+Description:
+    Longest path over all start vertices: every vertex starts with distance 0, so each vertex
+    ends up with the heaviest path ending at it (or 0 if no path into it beats starting there).
+    The vertex with the largest value ends the critical path, which is read back through the
+    parents.
+Parameters:
+    - int numThreads: number of threads, <= 0 for one per hardware thread.
+Return:
+    - CriticalPath<W>: the path length and its vertices (empty for a graph with no vertices).
+=================================================================================================*/
+template <typename W>
+CriticalPath<W> WeightedGraph<W>::criticalPath(int numThreads) const {
+    std::vector<WeightedTraversalData<W> > data = dagPaths(-1, true, numThreads);
+
+    CriticalPath<W> result;
+    result.length = 0;
+    int last = -1;
+    for (int v = 0; v < numVertices(); ++v) {
+        if (last == -1 || data[v].distance > result.length) {
+            result.length = data[v].distance;
+            last = v;
+        }
+    }
+    for (int v = last; v != -1; v = data[v].parent) {
+        result.path.push_back(v);
+    }
+    std::reverse(result.path.begin(), result.path.end());
+    return result;
+}
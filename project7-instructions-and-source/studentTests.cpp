@@ -1,9 +1,45 @@
 #include <iostream>
 #include <cassert>
+#include <cmath>
 #include <limits>
+#include <sstream>
+#include <chrono>
+#include <thread>
+#include <fstream>
+#include <cstdio>
+#include <atomic>
+#include <stdexcept>
 #include "Graph.hpp"
+#include "DagExecutor.hpp"
+#include "ReachabilityIndex.hpp"
+#include "DistanceIndex.hpp"
+#include "WeightedGraph.hpp"
+#include "MappedGraph.hpp"
+#ifdef GRAPH_WITH_ZLIB
+#include <zlib.h>
+#endif
 
 
+// pseudo-random numbers for the tests, from a linear congruential generator so every run
+// builds the same graphs: advances seed and returns a number in [0, bound)
+int nextRandom(unsigned &seed, int bound) {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) % bound;
+}
+
+// m random edges (u, v) on n vertices, the same for the same seed; targets are below maxTarget
+// (n if it is 0), so a small maxTarget gives many repeated edges
+std::vector<std::pair<int, int> > randomEdges(int n, long long m, unsigned seed, int maxTarget = 0) {
+    std::vector<std::pair<int, int> > edges;
+    edges.reserve(m);
+    for (long long i = 0; i < m; ++i) {
+        int u = nextRandom(seed, n);
+        int v = nextRandom(seed, maxTarget > 0 ? maxTarget : n);
+        edges.push_back(std::make_pair(u, v));
+    }
+    return edges;
+}
+
 // test cases for graphs
 
 // Test construction and addEdge/edgeIn
@@ -120,6 +156,1443 @@ void testDFS() {
     
 }
 
+// Test CSR snapshot traversals match the Graph traversals
+void testFreeze() {
+    Graph g(7);
+    g.addEdge(0, 3);
+    g.addEdge(0, 1);
+    g.addEdge(1, 2);
+    g.addEdge(3, 2);
+    g.addEdge(2, 4);
+    g.addEdge(5, 4);
+    g.addEdge(5, 6);
+
+    CsrGraph csr = g.freeze();
+    assert(csr.numVertices() == 7);
+    assert(csr.numEdges() == 7);
+    assert(csr.outDegree(0) == 2);
+    assert(*csr.neighborsBegin(0) == 3);
+
+    auto bfs = g.breadthFirstSearch(0);
+    auto csrBfs = csr.breadthFirstSearch(0);
+    for (int v = 0; v < 7; ++v) {
+        assert(bfs[v].visited == csrBfs[v].visited);
+        assert(bfs[v].parent == csrBfs[v].parent);
+        assert(bfs[v].distance == csrBfs[v].distance);
+    }
+
+    auto dfs = g.depthFirstSearch();
+    auto csrDfs = csr.depthFirstSearch();
+    for (int v = 0; v < 7; ++v) {
+        assert(dfs[v].parent == csrDfs[v].parent);
+        assert(dfs[v].discovery == csrDfs[v].discovery);
+        assert(dfs[v].finish == csrDfs[v].finish);
+        assert(dfs[v].order == csrDfs[v].order);
+    }
+
+    // the snapshot does not change with the graph
+    g.addEdge(6, 0);
+    assert(csr.numEdges() == 7);
+
+    std::cout << "CSR snapshot test passed.\n";
+}
+
+// Test the hashed edge index gives the same answers as the plain scan
+void testEdgeIndex() {
+    Graph plain(300);
+    Graph indexed(300);
+    indexed.enableEdgeIndex(4);
+
+    // vertex 0 becomes a hub, the rest stay below the threshold
+    for (int v = 1; v < 300; v += 2) {
+        plain.addEdge(0, v);
+        indexed.addEdge(0, v);
+    }
+    indexed.addEdge(0, 1); // duplicate, ignored
+    plain.addEdge(1, 2);
+    indexed.addEdge(1, 2);
+
+    for (int v = 0; v < 300; ++v) {
+        assert(plain.edgeIn(0, v) == indexed.edgeIn(0, v));
+    }
+    assert(indexed.edgeIn(1, 2));
+
+    // remove and re-add through deleted markers
+    for (int v = 1; v < 300; v += 4) {
+        indexed.removeEdge(0, v);
+        plain.removeEdge(0, v);
+    }
+    assert(!indexed.edgeIn(0, 1));
+    try {
+        indexed.removeEdge(0, 1);
+        assert(false); // should throw
+    } catch (const std::out_of_range&) {
+    }
+    indexed.addEdge(0, 1);
+    plain.addEdge(0, 1);
+
+    // neighbor order is unchanged, so traversals agree
+    Graph copy(indexed);
+    auto a = plain.depthFirstSearch();
+    auto b = copy.depthFirstSearch();
+    for (int v = 0; v < 300; ++v) {
+        assert(a[v].discovery == b[v].discovery);
+        assert(a[v].finish == b[v].finish);
+    }
+
+    copy.disableEdgeIndex();
+    assert(copy.edgeIn(0, 1) && !copy.edgeIn(0, 5));
+
+    std::cout << "Edge index test passed.\n";
+}
+
+// Test the bulk loader builds the same graph as addEdge and reports progress
+void testReadFromStream() {
+    std::istringstream in("5 5\n0 2\n0 1\r\n1 3\n1 4\n0 2\n");
+    std::vector<long long> reports;
+    Graph g = Graph::readFromStream(in, [&](long long done, long long total) {
+        assert(total == 5);
+        reports.push_back(done);
+    }, 2);
+
+    assert(g.edgeIn(0, 2));
+    assert(g.edgeIn(0, 1));
+    assert(g.edgeIn(1, 3));
+    assert(g.edgeIn(1, 4));
+    assert(!g.edgeIn(3, 4));
+    assert(reports.size() == 3 && reports[0] == 2 && reports[1] == 4 && reports[2] == 5);
+
+    // neighbor order follows the input order
+    auto bfs = g.breadthFirstSearch(0);
+    assert(bfs[3].parent == 1 && bfs[4].distance == 2);
+
+    // truncated input and bad vertices are rejected
+    std::string truncated = "3 2\n0 1\n";
+    try {
+        Graph::readFromBuffer(truncated.data(), truncated.data() + truncated.size());
+        assert(false); // should throw
+    } catch (const std::invalid_argument& e) {
+        assert(std::string(e.what()) == "readFromBuffer: expected 2 edges, got 1");
+    }
+    std::string badVertex = "3 1\n0 3\n";
+    try {
+        Graph::readFromBuffer(badVertex.data(), badVertex.data() + badVertex.size());
+        assert(false); // should throw
+    } catch (const std::out_of_range& e) {
+        assert(std::string(e.what()) == "readFromBuffer: vertex index out of range");
+    }
+    std::istringstream badStream(badVertex);
+    try {
+        Graph::readFromStream(badStream);
+        assert(false); // should throw
+    } catch (const std::out_of_range& e) {
+        assert(std::string(e.what()) == "readFromStream: vertex index out of range");
+    }
+
+    std::cout << "readFromStream test passed.\n";
+}
+
+// Test direction-optimizing BFS gives the same distances as the top-down BFS
+void testDirectionOptimizingBFS() {
+    // dense enough that the bottom-up steps kick in
+    Graph g(200);
+    for (const std::pair<int, int> &e : randomEdges(200, 3000, 12345)) {
+        g.addEdge(e.first, e.second);
+    }
+
+    for (int round = 0; round < 2; ++round) {
+        auto td = g.breadthFirstSearch(0);
+        auto dobfs = g.breadthFirstSearch(0, BfsMode::DirectionOptimizing);
+        for (int v = 0; v < 200; ++v) {
+            assert(td[v].visited == dobfs[v].visited);
+            assert(td[v].distance == dobfs[v].distance);
+            if (v != 0 && dobfs[v].visited) {
+                // the parent must be one level closer and have an edge to v
+                int p = dobfs[v].parent;
+                assert(g.edgeIn(p, v));
+                assert(dobfs[p].distance == dobfs[v].distance - 1);
+            }
+        }
+
+        // the in-edges are kept in sync with later changes
+        g.addEdge(199, 0);
+        if (g.edgeIn(0, 1)) {
+            g.removeEdge(0, 1);
+        }
+    }
+
+    std::cout << "Direction-optimizing BFS test passed.\n";
+}
+
+// Test that a ThreadTeam runs every round on all its threads and survives an exception
+void testThreadTeam() {
+    ThreadTeam team(4);
+    std::vector<int> hits(team.size(), 0);
+    for (int round = 0; round < 1000; ++round) {
+        team.run([&](int t) { ++hits[t]; });
+    }
+    for (int count : hits) {
+        assert(count == 1000);
+    }
+
+    try {
+        team.run([](int t) {
+            if (t == 2) {
+                throw std::runtime_error("round failed");
+            }
+        });
+        assert(false); // should throw
+    } catch (const std::runtime_error&) {
+    }
+    std::atomic<int> after(0);
+    team.run([&](int) { ++after; });
+    assert(after == 4);
+
+    std::cout << "Thread team test passed.\n";
+}
+
+// Test parallel BFS matches the serial BFS
+void testParallelBFS() {
+    // wide enough that the frontier is split across threads
+    int n = 20000;
+    Graph g(n);
+    for (const std::pair<int, int> &e : randomEdges(n, 100000, 777)) {
+        g.addEdge(e.first, e.second);
+    }
+
+    auto serial = g.breadthFirstSearch(0);
+    auto loose = g.parallelBreadthFirstSearch(0, 4);
+    auto exact = g.parallelBreadthFirstSearch(0, 4, true);
+    for (int v = 0; v < n; ++v) {
+        assert(loose[v].visited == serial[v].visited);
+        assert(loose[v].distance == serial[v].distance);
+        if (v != 0 && loose[v].visited) {
+            assert(g.edgeIn(loose[v].parent, v));
+            assert(loose[loose[v].parent].distance == loose[v].distance - 1);
+        }
+        assert(exact[v].distance == serial[v].distance);
+        assert(exact[v].parent == serial[v].parent);
+    }
+
+    // a long path into a wide fan and out again: thousands of one-vertex levels around
+    // a level large enough to wake the workers
+    int chain = 5000, fan = 5000;
+    Graph deep(2 * chain + fan + 1);
+    for (int v = 0; v + 1 < chain; ++v) {
+        deep.addEdge(v, v + 1);
+    }
+    for (int f = 0; f < fan; ++f) {
+        deep.addEdge(chain - 1, chain + f);
+        deep.addEdge(chain + f, chain + fan);
+    }
+    for (int v = chain + fan; v < 2 * chain + fan; ++v) {
+        deep.addEdge(v, v + 1);
+    }
+    auto deepSerial = deep.breadthFirstSearch(0);
+    auto deepExact = deep.parallelBreadthFirstSearch(0, 4, true);
+    for (int v = 0; v < deep.numVertices(); ++v) {
+        assert(deepExact[v].distance == deepSerial[v].distance);
+        assert(deepExact[v].parent == deepSerial[v].parent);
+    }
+    assert(deepExact[2 * chain + fan].distance == 2 * chain + 1);
+
+    std::cout << "Parallel BFS test passed.\n";
+}
+
+// Test DFS on a long path (would overflow a recursive DFS) and its exact times on a small graph
+void testIterativeDFS() {
+    int n = 500000;
+    Graph path(n);
+    for (int v = 0; v + 1 < n; ++v) {
+        path.addEdge(v, v + 1);
+    }
+    auto dfs = path.depthFirstSearch();
+    assert(dfs[n - 1].discovery == n);
+    assert(dfs[n - 1].finish == n + 1);
+    assert(dfs[0].finish == 2 * n);
+    assert(dfs[0].order == 1 && dfs[n - 1].order == n);
+    assert(dfs[n - 1].parent == n - 2);
+
+    // times from a hand-traced recursive DFS
+    Graph g(4);
+    g.addEdge(0, 2);
+    g.addEdge(0, 1);
+    g.addEdge(2, 1);
+    g.addEdge(3, 0);
+    auto small = g.depthFirstSearch();
+    assert(small[0].discovery == 1 && small[0].finish == 6);
+    assert(small[2].discovery == 2 && small[2].finish == 5 && small[2].parent == 0);
+    assert(small[1].discovery == 3 && small[1].finish == 4 && small[1].parent == 2);
+    assert(small[3].discovery == 7 && small[3].finish == 8);
+    assert(small[1].order == 4 && small[2].order == 3 && small[0].order == 2 && small[3].order == 1);
+
+    std::cout << "Iterative DFS test passed.\n";
+}
+
+// Test traversals through a reused workspace match the plain ones
+void testTraversalWorkspace() {
+    Graph g(8);
+    g.addEdge(0, 1);
+    g.addEdge(0, 2);
+    g.addEdge(1, 3);
+    g.addEdge(2, 3);
+    g.addEdge(3, 4);
+    g.addEdge(5, 6);
+    g.addEdge(6, 7);
+
+    TraversalWorkspace ws;
+    for (int s = 0; s < 8; ++s) {
+        auto bfs = g.breadthFirstSearch(s);
+        g.breadthFirstSearch(s, ws);
+        for (int v = 0; v < 8; ++v) {
+            TraversalData d = ws.get(v);
+            assert(d.visited == bfs[v].visited);
+            assert(d.parent == bfs[v].parent);
+            assert(d.distance == bfs[v].distance);
+        }
+    }
+
+    // only the reached vertices are listed
+    g.breadthFirstSearch(5, ws);
+    assert(ws.reached().size() == 3);
+    assert(ws.visited(7) && !ws.visited(0));
+
+    // a DFS from 0 agrees with the full DFS, which also starts at 0
+    auto dfs = g.depthFirstSearch();
+    g.depthFirstSearch(0, ws);
+    assert(ws.reached().size() == 5);
+    for (int v = 0; v <= 4; ++v) {
+        assert(ws.get(v).discovery == dfs[v].discovery);
+        assert(ws.get(v).finish == dfs[v].finish);
+        assert(ws.get(v).parent == dfs[v].parent);
+    }
+    // orders number the reached vertices 1...5
+    std::vector<int> seenOrders(6, 0);
+    for (int v : ws.reached()) {
+        seenOrders[ws.get(v).order]++;
+    }
+    for (int i = 1; i <= 5; ++i) {
+        assert(seenOrders[i] == 1);
+    }
+    assert(!ws.get(6).visited);
+
+    std::cout << "Traversal workspace test passed.\n";
+}
+
+// Test field-selectable BFS results match the full BFS
+void testBFSFields() {
+    Graph g(70);
+    for (int v = 0; v + 1 < 69; ++v) {
+        g.addEdge(v, v + 1);
+    }
+    g.addEdge(0, 10);
+
+    auto full = g.breadthFirstSearch(0);
+    auto all = g.breadthFirstSearchFields<TraversalFields::Visited | TraversalFields::Parent |
+                                          TraversalFields::Distance>(0);
+    auto distOnly = g.breadthFirstSearchFields<TraversalFields::Distance, std::uint8_t>(0);
+    auto visitedOnly = g.breadthFirstSearchFields<TraversalFields::Visited>(0);
+    auto wide = g.breadthFirstSearchFields<TraversalFields::Distance, std::uint64_t>(0);
+    assert(distOnly.parent.empty() && distOnly.visitedBits.empty() && visitedOnly.distance.empty());
+
+    for (int v = 0; v < 70; ++v) {
+        assert(all.visited(v) == full[v].visited);
+        assert(visitedOnly.visited(v) == full[v].visited);
+        assert(all.parent[v] == full[v].parent);
+        assert(all.distance[v] == full[v].distance);
+        if (full[v].visited) {
+            assert(distOnly.distance[v] == full[v].distance);
+            assert(wide.distance[v] == static_cast<std::uint64_t>(full[v].distance));
+        } else {
+            assert(distOnly.distance[v] == 255);
+            assert(wide.distance[v] == std::numeric_limits<std::uint64_t>::max());
+        }
+    }
+
+    // a path longer than the distance type can count is reported
+    Graph path(300);
+    for (int v = 0; v + 1 < 255; ++v) {
+        path.addEdge(v, v + 1);
+    }
+    // 254 is the largest distance a uint8 can hold
+    assert((path.breadthFirstSearchFields<TraversalFields::Distance, std::uint8_t>(0).distance[254] == 254));
+    for (int v = 254; v + 1 < 300; ++v) {
+        path.addEdge(v, v + 1);
+    }
+    try {
+        path.breadthFirstSearchFields<TraversalFields::Distance, std::uint8_t>(0);
+        assert(false); // should throw
+    } catch (const std::overflow_error&) {
+    }
+
+    std::cout << "BFS field selection test passed.\n";
+}
+
+// Test bidirectional shortest paths against BFS distances
+void testShortestPath() {
+    int n = 300;
+    Graph g(n);
+    for (const std::pair<int, int> &e : randomEdges(n, 600, 4242)) {
+        g.addEdge(e.first, e.second);
+    }
+
+    TraversalWorkspace forward, backward;
+    for (int s = 0; s < n; s += 37) {
+        auto bfs = g.breadthFirstSearch(s);
+        for (int t = 0; t < n; ++t) {
+            PathResult r = g.shortestPath(s, t, forward, backward);
+            assert(r.distance == bfs[t].distance);
+            if (!bfs[t].visited) {
+                assert(r.path.empty());
+                continue;
+            }
+            // the path is a real path of that length
+            assert(static_cast<int>(r.path.size()) == r.distance + 1);
+            assert(r.path.front() == s && r.path.back() == t);
+            for (size_t i = 0; i + 1 < r.path.size(); ++i) {
+                assert(g.edgeIn(r.path[i], r.path[i + 1]));
+            }
+        }
+    }
+
+    PathResult self = g.shortestPath(5, 5);
+    assert(self.distance == 0 && self.path.size() == 1);
+
+    std::cout << "Bidirectional shortest path test passed.\n";
+}
+
+// Test multi-source BFS against one BFS per source
+void testMultiSourceBFS() {
+    int n = 150;
+    Graph g(n);
+    for (const std::pair<int, int> &e : randomEdges(n, 400, 99)) {
+        g.addEdge(e.first, e.second);
+    }
+
+    // more than one batch of 64, with a repeated source
+    std::vector<int> sources;
+    for (int s = 0; s < n; ++s) {
+        sources.push_back(s);
+    }
+    sources.push_back(3);
+
+    auto all = g.multiSourceBFS(sources);
+    assert(all.size() == sources.size());
+    for (size_t i = 0; i < sources.size(); ++i) {
+        auto bfs = g.breadthFirstSearch(sources[i]);
+        for (int v = 0; v < n; ++v) {
+            assert(all[i][v] == bfs[v].distance);
+        }
+    }
+
+    std::cout << "Multi-source BFS test passed.\n";
+}
+
+// Test topological sequence and dependency levels
+void testTopologicalSort() {
+    Graph g(6);
+    g.addEdge(5, 2);
+    g.addEdge(5, 0);
+    g.addEdge(4, 0);
+    g.addEdge(4, 1);
+    g.addEdge(2, 3);
+    g.addEdge(3, 1);
+
+    std::vector<int> sequence = g.topologicalSort();
+    assert(sequence.size() == 6);
+    std::vector<int> position(6);
+    for (int i = 0; i < 6; ++i) {
+        position[sequence[i]] = i;
+    }
+    assert(position[5] < position[2] && position[2] < position[3] && position[3] < position[1]);
+    assert(position[4] < position[0] && position[4] < position[1] && position[5] < position[0]);
+
+    auto levels = g.topologicalLevels(2);
+    assert(levels.size() == 4);
+    assert((levels[0] == std::vector<int>{4, 5}));
+    assert((levels[1] == std::vector<int>{0, 2}));
+    assert((levels[2] == std::vector<int>{3}));
+    assert((levels[3] == std::vector<int>{1}));
+
+    // a wide DAG that is split across threads gives the same levels
+    int n = 5000;
+    Graph wide(n);
+    for (int v = 1; v < n; ++v) {
+        wide.addEdge(v / 2, v); // binary tree, plus cross edges to the next level
+        if (2 * v + 2 < n) {
+            wide.addEdge(v - 1, 2 * v + 2);
+        }
+    }
+    auto serial = wide.topologicalLevels(1);
+    auto parallel = wide.topologicalLevels(4);
+    assert(serial == parallel);
+
+    // deep and wide: 300 levels of 1500 vertices, each level run by the same threads
+    int width = 1500, depth = 300;
+    Graph layered(width * depth);
+    for (int d = 0; d + 1 < depth; ++d) {
+        for (int i = 0; i < width; ++i) {
+            layered.addEdge(d * width + i, (d + 1) * width + (i * 7 + d) % width);
+            layered.addEdge(d * width + i, (d + 1) * width + i);
+        }
+    }
+    auto layers = layered.topologicalLevels(4);
+    assert(static_cast<int>(layers.size()) == depth);
+    for (int d = 0; d < depth; ++d) {
+        assert(static_cast<int>(layers[d].size()) == width && layers[d][0] == d * width);
+    }
+
+    g.addEdge(1, 5); // now 5 -> 2 -> 3 -> 1 -> 5 is a cycle
+    try {
+        g.topologicalSort();
+        assert(false); // should throw
+    } catch (const std::invalid_argument&) {
+    }
+    try {
+        g.topologicalLevels();
+        assert(false); // should throw
+    } catch (const std::invalid_argument&) {
+    }
+
+    std::cout << "Topological sort test passed.\n";
+}
+
+// Test the DAG executor respects dependencies, reports task errors and cycles
+void testDagExecutor() {
+    int n = 2000;
+    Graph g(n);
+    for (int v = 1; v < n; ++v) {
+        g.addEdge((v - 1) / 3, v);
+        if (v >= 7) {
+            g.addEdge(v - 7, v);
+        }
+    }
+
+    std::atomic<int> clock(0);
+    std::vector<int> started(n, -1), finished(n, -1);
+    DagExecutor executor(4);
+    assert(executor.workers() == 4);
+    executor.run(g, [&](int v) {
+        started[v] = clock.fetch_add(1);
+        finished[v] = clock.fetch_add(1);
+    });
+    for (int u = 0; u < n; ++u) {
+        assert(started[u] >= 0);
+        for (int v = 0; v < n; v += 97) {
+            if (g.edgeIn(u, v)) {
+                assert(finished[u] < started[v]);
+            }
+        }
+    }
+
+    // the first task error is passed on
+    try {
+        executor.run(g, [](int v) {
+            if (v == 10) {
+                throw std::runtime_error("task failed");
+            }
+        });
+        assert(false); // should throw
+    } catch (const std::runtime_error&) {
+    }
+
+    // a cycle leaves tasks that can never run
+    Graph cyclic(4);
+    cyclic.addEdge(0, 1);
+    cyclic.addEdge(1, 2);
+    cyclic.addEdge(2, 1);
+    std::atomic<int> ran(0);
+    try {
+        executor.run(cyclic, [&](int) { ran.fetch_add(1); });
+        assert(false); // should throw
+    } catch (const std::invalid_argument&) {
+    }
+    assert(ran.load() == 2); // vertices 0 and 3
+
+    // idle workers sleep instead of spinning: while task 1 runs there is nothing else to do,
+    // so the other three workers must all end up waiting (spinning ones never would)
+    Graph chain(3);
+    chain.addEdge(0, 1);
+    chain.addEdge(1, 2);
+    DagExecutor idle(4);
+    bool allAsleep = false;
+    idle.run(chain, [&](int v) {
+        if (v == 1) {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+            while (idle.idleWorkers() != 3 && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            allAsleep = idle.idleWorkers() == 3;
+        }
+    });
+    assert(allAsleep);
+    assert(idle.idleWorkers() == 0);
+
+    std::cout << "DAG executor test passed.\n";
+}
+
+// Test the online topological order stays valid and rejects cycles
+void testIncrementalTopologicalOrder() {
+    int n = 200;
+    Graph g(n);
+    g.addEdge(0, 1);
+    g.enableTopologicalOrder();
+
+    int rejected = 0;
+    for (const std::pair<int, int> &e : randomEdges(n, 1500, 2024)) {
+        int u = e.first, v = e.second;
+        bool existed = g.edgeIn(u, v);
+        try {
+            g.addEdge(u, v);
+        } catch (const std::invalid_argument&) {
+            assert(!existed && !g.edgeIn(u, v)); // graph left unchanged
+            ++rejected;
+        }
+    }
+    assert(rejected > 0);
+
+    // every edge goes forward in the maintained order
+    const std::vector<int>& order = g.topologicalOrder();
+    std::vector<int> position(n, -1);
+    for (int i = 0; i < n; ++i) {
+        position[order[i]] = i;
+    }
+    for (int u = 0; u < n; ++u) {
+        assert(position[u] >= 0);
+        for (int v = 0; v < n; ++v) {
+            if (g.edgeIn(u, v)) {
+                assert(position[u] < position[v]);
+            }
+        }
+    }
+
+    try {
+        g.addEdge(7, 7);
+        assert(false); // should throw
+    } catch (const std::invalid_argument&) {
+    }
+
+    g.disableTopologicalOrder();
+    try {
+        g.topologicalOrder();
+        assert(false); // should throw
+    } catch (const std::logic_error&) {
+    }
+
+    std::cout << "Incremental topological order test passed.\n";
+}
+
+// Test strongly connected components, serial and parallel, and the condensation
+void testStronglyConnectedComponents() {
+    Graph g(8);
+    // {0, 1, 2} and {3, 4} are cycles, 5 -> 6 -> 7 are singletons
+    g.addEdge(0, 1);
+    g.addEdge(1, 2);
+    g.addEdge(2, 0);
+    g.addEdge(2, 3);
+    g.addEdge(3, 4);
+    g.addEdge(4, 3);
+    g.addEdge(5, 6);
+    g.addEdge(6, 7);
+    g.addEdge(7, 4);
+
+    ComponentResult tarjan = g.stronglyConnectedComponents();
+    assert(tarjan.count == 5);
+    assert(tarjan.component[0] == tarjan.component[1] && tarjan.component[1] == tarjan.component[2]);
+    assert(tarjan.component[3] == tarjan.component[4]);
+    assert(tarjan.sizes[tarjan.component[0]] == 3);
+    // components only point to smaller ids
+    assert(tarjan.component[2] > tarjan.component[3]);
+    assert(tarjan.component[7] > tarjan.component[4]);
+
+    Graph dag = g.condensation(tarjan);
+    assert(dag.edgeIn(tarjan.component[0], tarjan.component[3]));
+    assert(dag.topologicalSort().size() == 5); // acyclic
+
+    // both algorithms agree on a larger random graph
+    int n = 3000;
+    Graph big(n);
+    for (const std::pair<int, int> &e : randomEdges(n, 4500, 31337)) {
+        big.addEdge(e.first, e.second);
+    }
+    ComponentResult serial = big.stronglyConnectedComponents();
+    ComponentResult parallel = big.parallelStronglyConnectedComponents(4);
+    assert(serial.count == parallel.count);
+    std::vector<int> match(serial.count, -1);
+    for (int v = 0; v < n; ++v) {
+        // same partition: serial ids map one-to-one onto parallel ids
+        int &m = match[serial.component[v]];
+        if (m == -1) {
+            m = parallel.component[v];
+        }
+        assert(m == parallel.component[v]);
+        assert(serial.sizes[serial.component[v]] == parallel.sizes[parallel.component[v]]);
+    }
+
+    // deep graph: one cycle through every vertex
+    int len = 300000;
+    Graph ring(len);
+    for (int v = 0; v < len; ++v) {
+        ring.addEdge(v, (v + 1) % len);
+    }
+    assert(ring.stronglyConnectedComponents().count == 1);
+    assert(ring.parallelStronglyConnectedComponents(2).count == 1);
+
+    // 2000 chains of 200 vertices: 200 trim rounds, each wide enough to run on all threads
+    int chains = 2000, chainLength = 200;
+    Graph strands(chains * chainLength);
+    for (int c = 0; c < chains; ++c) {
+        for (int i = 0; i + 1 < chainLength; ++i) {
+            strands.addEdge(c * chainLength + i, c * chainLength + i + 1);
+        }
+    }
+    assert(strands.parallelStronglyConnectedComponents(4).count == chains * chainLength);
+
+    std::cout << "Strongly connected components test passed.\n";
+}
+
+// Test weakly connected components against BFS over both edge directions
+void testWeaklyConnectedComponents() {
+    Graph g(7);
+    g.addEdge(1, 0);
+    g.addEdge(2, 0);
+    g.addEdge(3, 4);
+    g.addEdge(5, 4);
+    ComponentResult wcc = g.weaklyConnectedComponents(2);
+    assert(wcc.count == 3);
+    assert((wcc.component == std::vector<int>{0, 0, 0, 1, 1, 1, 2}));
+    assert((wcc.sizes == std::vector<int>{3, 3, 1}));
+
+    // random graph with a giant component and many small ones
+    int n = 5000;
+    Graph big(n);
+    Graph both(n); // every edge in both directions
+    for (const std::pair<int, int> &e : randomEdges(n, 3000, 8675309)) {
+        big.addEdge(e.first, e.second);
+        both.addEdge(e.first, e.second);
+        both.addEdge(e.second, e.first);
+    }
+    ComponentResult result = big.weaklyConnectedComponents(4);
+    std::vector<int> label(n, -1);
+    int count = 0;
+    for (int s = 0; s < n; ++s) {
+        if (label[s] != -1) {
+            continue;
+        }
+        auto bfs = both.breadthFirstSearch(s);
+        for (int v = 0; v < n; ++v) {
+            if (bfs[v].visited) {
+                label[v] = count;
+            }
+        }
+        ++count;
+    }
+    assert(result.count == count);
+    assert(result.component == label);
+
+    std::cout << "Weakly connected components test passed.\n";
+}
+
+// Test reachability queries against BFS
+void testReachabilityIndex() {
+    int n = 400;
+    Graph g(n);
+    for (const std::pair<int, int> &e : randomEdges(n, 700, 55)) {
+        g.addEdge(e.first, e.second); // cycles are fine, they are condensed first
+    }
+
+    const Graph &readOnly = g; // building the index only reads the graph
+    ReachabilityIndex index(readOnly, 3, 7);
+    std::vector<std::vector<char> > reach(n, std::vector<char>(n));
+    for (int u = 0; u < n; ++u) {
+        auto bfs = g.breadthFirstSearch(u);
+        for (int v = 0; v < n; ++v) {
+            reach[u][v] = bfs[v].visited;
+        }
+    }
+    for (int u = 0; u < n; u += 3) {
+        for (int v = 0; v < n; ++v) {
+            assert(index.canReach(u, v) == reach[u][v]);
+        }
+    }
+
+    // concurrent queries on one index
+    const ReachabilityIndex &shared = index;
+    std::atomic<int> wrong(0);
+    runOnThreads(4, [&](int t) {
+        for (int u = t; u < n; u += 4) {
+            for (int v = 0; v < n; ++v) {
+                if (shared.canReach(u, v) != static_cast<bool>(reach[u][v])) {
+                    ++wrong;
+                }
+            }
+        }
+    });
+    assert(wrong == 0);
+
+    try {
+        index.canReach(0, n);
+        assert(false); // should throw
+    } catch (const std::out_of_range&) {
+    }
+
+    std::cout << "Reachability index test passed.\n";
+}
+
+// Test pruned landmark labeling distances against BFS, before and after a save/load
+void testDistanceIndex() {
+    int n = 300;
+    Graph g(n);
+    for (const std::pair<int, int> &e : randomEdges(n, 900, 1717)) {
+        g.addEdge(e.first, e.second);
+    }
+
+    DistanceIndex index(g);
+    std::stringstream buffer;
+    index.save(buffer);
+    DistanceIndex loaded = DistanceIndex::load(buffer);
+    assert(loaded.numVertices() == n && loaded.labelSize() == index.labelSize());
+
+    for (int s = 0; s < n; s += 7) {
+        auto bfs = g.breadthFirstSearch(s);
+        for (int t = 0; t < n; ++t) {
+            assert(index.distance(s, t) == bfs[t].distance);
+            assert(loaded.distance(s, t) == bfs[t].distance);
+        }
+    }
+
+    CsrGraph reversed = g.freeze().transpose();
+    assert(reversed.numEdges() == g.freeze().numEdges());
+
+    std::stringstream garbage("not an index");
+    try {
+        DistanceIndex::load(garbage);
+        assert(false); // should throw
+    } catch (const std::invalid_argument&) {
+    }
+
+    std::cout << "Distance index test passed.\n";
+}
+
+// Test weighted edges and Dijkstra against a Bellman-Ford reference
+void testDijkstra() {
+    WeightedGraph<int> g(5);
+    g.addEdge(0, 1, 10);
+    g.addEdge(0, 2, 3);
+    g.addEdge(2, 1, 4);
+    g.addEdge(1, 3, 2);
+    g.addEdge(2, 3, 8);
+    g.addEdge(0, 2, 5); // updates the weight
+    assert(g.weight(0, 2) == 5);
+    assert(g.topology().edgeIn(2, 1));
+
+    auto d = g.dijkstra(0);
+    assert(d[1].distance == 9 && d[1].parent == 2);
+    assert(d[3].distance == 11 && d[3].parent == 1);
+    assert(!d[4].visited && d[4].distance == std::numeric_limits<int>::max());
+
+    g.removeEdge(0, 1);
+    assert(!g.edgeIn(0, 1) && g.weight(0, 2) == 5);
+
+    // random graph with double weights
+    int n = 200;
+    WeightedGraph<double> r(n);
+    unsigned seed = 606;
+    for (const std::pair<int, int> &e : randomEdges(n, 1200, seed)) {
+        r.addEdge(e.first, e.second, nextRandom(seed, 100) / 4.0);
+    }
+    auto dist = r.dijkstra(0);
+
+    std::vector<double> reference(n, std::numeric_limits<double>::max());
+    reference[0] = 0;
+    for (int round = 0; round < n; ++round) {
+        for (int u = 0; u < n; ++u) {
+            if (reference[u] == std::numeric_limits<double>::max()) {
+                continue;
+            }
+            const std::vector<int> &out = r.topology().neighbors(u);
+            for (size_t i = 0; i < out.size(); ++i) {
+                reference[out[i]] = std::min(reference[out[i]], reference[u] + r.weights(u)[i]);
+            }
+        }
+    }
+    for (int v = 0; v < n; ++v) {
+        assert(dist[v].distance == reference[v]);
+        if (dist[v].visited && v != 0) {
+            assert(dist[dist[v].parent].distance + r.weight(dist[v].parent, v) == dist[v].distance);
+        }
+    }
+
+    WeightedGraph<int> negative(2);
+    negative.addEdge(0, 1, -1);
+    try {
+        negative.dijkstra(0);
+        assert(false); // should throw
+    } catch (const std::invalid_argument&) {
+    }
+
+    std::cout << "Weighted graph and Dijkstra test passed.\n";
+}
+
+// Test delta-stepping against Dijkstra
+void testDeltaStepping() {
+    int n = 3000;
+    WeightedGraph<long long> g(n);
+    WeightedGraph<double> h(n);
+    unsigned seed = 4711;
+    for (const std::pair<int, int> &e : randomEdges(n, 15000, seed)) {
+        long long w = nextRandom(seed, 50); // includes zero weights
+        g.addEdge(e.first, e.second, w);
+        h.addEdge(e.first, e.second, w / 8.0);
+    }
+
+    auto expected = g.dijkstra(0);
+    long long deltas[] = {1, 7, 1000};
+    for (long long delta : deltas) {
+        auto result = g.deltaStepping(0, delta, 4);
+        for (int v = 0; v < n; ++v) {
+            assert(result[v].visited == expected[v].visited);
+            assert(result[v].distance == expected[v].distance);
+            if (result[v].visited && v != 0) {
+                int p = result[v].parent;
+                assert(result[p].distance + g.weight(p, v) == result[v].distance);
+            }
+        }
+    }
+
+    auto expectedDouble = h.dijkstra(0);
+    auto resultDouble = h.deltaStepping(0, 2.5, 4);
+    for (int v = 0; v < n; ++v) {
+        assert(resultDouble[v].distance == expectedDouble[v].distance);
+    }
+
+    // weights that are not exact in binary: every reached vertex still gets a parent, and the
+    // parents lead back to the source
+    WeightedGraph<double> fractions(n);
+    for (const std::pair<int, int> &e : randomEdges(n, 15000, 4712)) {
+        fractions.addEdge(e.first, e.second, nextRandom(seed, 1000) * 0.1 + 1.0 / 3);
+    }
+    auto expectedFractions = fractions.dijkstra(0);
+    for (double delta : {0.7, 10.0}) {
+        auto result = fractions.deltaStepping(0, delta, 4);
+        for (int v = 0; v < n; ++v) {
+            assert(result[v].visited == expectedFractions[v].visited);
+            if (!result[v].visited || v == 0) {
+                continue;
+            }
+            assert(std::abs(result[v].distance - expectedFractions[v].distance) < 1e-9);
+            int p = result[v].parent;
+            assert(p != -1 && fractions.edgeIn(p, v));
+            assert(std::abs(result[p].distance + fractions.weight(p, v) - result[v].distance) < 1e-9);
+            int steps = 0;
+            for (int x = v; x != 0; x = result[x].parent) {
+                assert(++steps < n);
+            }
+        }
+    }
+
+    try {
+        g.deltaStepping(0, 0);
+        assert(false); // should throw
+    } catch (const std::invalid_argument&) {
+    }
+
+    std::cout << "Delta-stepping test passed.\n";
+}
+
+// Test DAG shortest/longest paths and the critical path
+void testDagPaths() {
+    // build DAG: 0 -> 1 -> 3, 0 -> 2 -> 3, 3 -> 4, 5 isolated
+    WeightedGraph<int> g(6);
+    g.addEdge(0, 1, 3);
+    g.addEdge(0, 2, 1);
+    g.addEdge(1, 3, 4);
+    g.addEdge(2, 3, -2);
+    g.addEdge(3, 4, 5);
+
+    auto shortest = g.dagShortestPaths(0);
+    assert(shortest[3].distance == -1 && shortest[3].parent == 2);
+    assert(shortest[4].distance == 4);
+    assert(!shortest[5].visited);
+
+    auto longest = g.dagLongestPaths(0);
+    assert(longest[3].distance == 7 && longest[3].parent == 1);
+    assert(longest[4].distance == 12);
+
+    CriticalPath<int> critical = g.criticalPath();
+    assert(critical.length == 12);
+    assert((critical.path == std::vector<int>{0, 1, 3, 4}));
+
+    // on a larger DAG with non-negative weights the shortest paths agree with Dijkstra,
+    // with levels split across threads
+    int n = 4000;
+    WeightedGraph<long long> big(n);
+    unsigned seed = 123;
+    for (const std::pair<int, int> &e : randomEdges(n, 16000, seed)) {
+        int w = nextRandom(seed, 20);
+        if (e.first < e.second) {
+            big.addEdge(e.first, e.second, w);
+        }
+    }
+    auto expected = big.dijkstra(0);
+    auto result = big.dagShortestPaths(0, 4);
+    for (int v = 0; v < n; ++v) {
+        assert(result[v].distance == expected[v].distance);
+    }
+
+    g.addEdge(4, 0, 1);
+    try {
+        g.criticalPath();
+        assert(false); // should throw
+    } catch (const std::invalid_argument&) {
+    }
+
+    std::cout << "DAG path test passed.\n";
+}
+
+// Test writing the binary graph format and traversing it through mmap
+void testMappedGraph() {
+    const char *path = "mappedGraphTest.bin";
+
+    int n = 3000;
+    WeightedGraph<double> g(n);
+    std::vector<std::pair<int, int> > edges = randomEdges(n, 12001, 99); // odd count exercises the weight padding
+    for (size_t i = 0; i < edges.size(); ++i) {
+        g.addEdge(edges[i].first, edges[i].second, i * 0.5);
+    }
+    long long m = 0;
+    for (int u = 0; u < n; ++u) {
+        m += g.topology().neighbors(u).size();
+    }
+
+    {
+        std::ofstream out(path, std::ios::binary);
+        MappedGraph::write(g, out);
+    }
+    MappedGraph mapped = MappedGraph::open(path, true);
+    assert(mapped.numVertices() == n && mapped.numEdges() == m);
+    assert(m % 2 == 1);
+    assert(mapped.hasWeights());
+
+    // same neighbors and weights, in the same order
+    for (int u = 0; u < n; ++u) {
+        const std::vector<int> &neighbors = g.topology().neighbors(u);
+        const double *w = mapped.weightsBegin<double>(u);
+        assert(mapped.graph().outDegree(u) == (int)neighbors.size());
+        for (size_t j = 0; j < neighbors.size(); ++j) {
+            assert(mapped.graph().neighborsBegin(u)[j] == neighbors[j]);
+            assert(w[j] == g.weights(u)[j]);
+        }
+    }
+
+    // traversals run on the mapped arrays and match the in-memory graph
+    auto bfs = g.topology().freeze().breadthFirstSearch(0);
+    auto mappedBfs = mapped.graph().breadthFirstSearch(0);
+    auto dfs = g.topology().freeze().depthFirstSearch();
+    auto mappedDfs = mapped.graph().depthFirstSearch();
+    for (int v = 0; v < n; ++v) {
+        assert(mappedBfs[v].visited == bfs[v].visited && mappedBfs[v].distance == bfs[v].distance);
+        assert(mappedDfs[v].discovery == dfs[v].discovery && mappedDfs[v].finish == dfs[v].finish);
+    }
+
+    try {
+        mapped.weightsBegin<int>(0);
+        assert(false); // should throw
+    } catch (const std::invalid_argument&) {
+    }
+
+    // the CsrGraph keeps the mapping alive after the MappedGraph is gone
+    CsrGraph kept = MappedGraph::open(path).graph();
+    assert(kept.numEdges() == m && kept.breadthFirstSearch(0)[n - 1].distance == bfs[n - 1].distance);
+
+    // unweighted file
+    {
+        std::ofstream out(path, std::ios::binary);
+        MappedGraph::write(g.topology(), out);
+    }
+    MappedGraph plain = MappedGraph::open(path, true);
+    assert(!plain.hasWeights() && plain.numEdges() == m);
+
+    // a flipped target byte is caught by verify but not by the cheap header checks
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(64 + 8 * (n + 1) + 4 * 10);
+        file.put(0x7f);
+    }
+    MappedGraph::open(path);
+    try {
+        MappedGraph::open(path, true);
+        assert(false); // should throw
+    } catch (const std::invalid_argument&) {
+    }
+
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "not a graph file, just some text that is long enough to hold a header............";
+    }
+    try {
+        MappedGraph::open(path);
+        assert(false); // should throw
+    } catch (const std::invalid_argument&) {
+    }
+    std::remove(path);
+
+    try {
+        MappedGraph::open("noSuchGraphFile.bin");
+        assert(false); // should throw
+    } catch (const std::runtime_error&) {
+    }
+
+    std::cout << "Mapped graph test passed.\n";
+}
+
+// Test the multi-threaded edge-list parser against the serial one
+void testParallelRead() {
+    // big enough for many 64 KB chunks, with duplicate edges, blank lines, CRLF line ends and
+    // padding around the numbers
+    int n = 5000;
+    long long m = 300000;
+    std::string text = std::to_string(n) + " " + std::to_string(m) + "\n";
+    std::vector<std::pair<int, int> > edges = randomEdges(n, m, 2024);
+    for (long long i = 0; i < m; ++i) {
+        int u = edges[i].first;
+        int v = i % 7 == 0 ? edges[i].second % 20 : edges[i].second; // small targets repeat often
+        text += std::to_string(u) + (i % 5 == 0 ? "\t " : " ") + std::to_string(v) + (i % 3 == 0 ? "\r\n" : "\n");
+        if (i % 1000 == 0) {
+            text += "\n";
+        }
+    }
+    text += "1 2\n3 4 5\nx\n0 9999999\n3 4   "; // lines after the first m edges are ignored, even bad ones
+
+    Graph expected = Graph::readFromBuffer(text.data(), text.data() + text.size());
+    for (int threads : {1, 4}) {
+        Graph g = Graph::parallelReadFromBuffer(text.data(), text.data() + text.size(), threads);
+        assert(g.numVertices() == n);
+        for (int u = 0; u < n; ++u) {
+            assert(g.neighbors(u) == expected.neighbors(u)); // same edges in the same order
+        }
+    }
+
+    const char *path = "parallelReadTest.txt";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << text;
+    }
+    Graph fromFile = Graph::parallelReadFromFile(path, 3);
+    for (int u = 0; u < n; ++u) {
+        assert(fromFile.neighbors(u) == expected.neighbors(u));
+    }
+    std::remove(path);
+
+    // a bad line within the first m edges is reported, wherever its chunk is
+    std::string broken = text;
+    broken.insert(broken.size() / 2, "\n7 x\n");
+    for (int threads : {1, 4}) {
+        try {
+            Graph::parallelReadFromBuffer(broken.data(), broken.data() + broken.size(), threads);
+            assert(false); // should throw
+        } catch (const std::invalid_argument& e) {
+            assert(std::string(e.what()).find("parallelReadFromBuffer:") == 0);
+        }
+    }
+
+    // the serial reader takes any whitespace between numbers, this one wants one edge per line
+    std::string twoPerLine = "3 2\n0 1 1 2\n";
+    Graph serial = Graph::readFromBuffer(twoPerLine.data(), twoPerLine.data() + twoPerLine.size());
+    assert(serial.edgeIn(0, 1) && serial.edgeIn(1, 2));
+
+    std::string bad[] = {"3 2\n0 1\n", "3 2\n0 1\n1 2 2\n", "3 1\n0 x\n", "", twoPerLine};
+    for (const std::string &input : bad) {
+        try {
+            Graph::parallelReadFromBuffer(input.data(), input.data() + input.size());
+            assert(false); // should throw
+        } catch (const std::invalid_argument&) {
+        }
+    }
+    std::string outside = "3 1\n0 3\n";
+    try {
+        Graph::parallelReadFromBuffer(outside.data(), outside.data() + outside.size());
+        assert(false); // should throw
+    } catch (const std::out_of_range& e) {
+        assert(std::string(e.what()) == "parallelReadFromBuffer: vertex index out of range");
+    }
+
+    std::cout << "Parallel read test passed.\n";
+}
+
+// Test bulk construction against building the same graph with addEdge
+void testFromEdges() {
+    int n = 2000;
+    std::vector<std::pair<int, int> > edges = randomEdges(n, 60000, 7);
+    Graph expected(n);
+    for (size_t i = 0; i < edges.size(); ++i) {
+        int &u = edges[i].first, &v = edges[i].second;
+        u = i % 2 == 0 ? u % 10 : u; // a few very high-degree sources
+        v = i % 3 == 0 ? v % 30 : v; // and many repeated edges
+        if (!expected.edgeIn(u, v)) {
+            expected.addEdge(u, v);
+        }
+    }
+
+    for (int threads : {1, 4}) {
+        Graph g = Graph::fromEdges(n, edges, threads);
+        assert(g.numVertices() == n);
+        for (int u = 0; u < n; ++u) {
+            assert(g.neighbors(u) == expected.neighbors(u));
+        }
+        // the result is an ordinary graph: adding an existing edge still changes nothing
+        size_t degree = g.neighbors(edges[0].first).size();
+        g.addEdge(edges[0].first, edges[0].second);
+        assert(g.neighbors(edges[0].first).size() == degree);
+    }
+
+    Graph empty = Graph::fromEdges(3, std::vector<std::pair<int, int> >());
+    assert(empty.numVertices() == 3 && empty.neighbors(0).empty());
+
+    try {
+        Graph::fromEdges(3, {{0, 1}, {1, 3}});
+        assert(false); // should throw
+    } catch (const std::out_of_range& e) {
+        assert(std::string(e.what()) == "fromEdges: vertex index out of range");
+    }
+    try {
+        Graph::fromEdges(-1, {});
+        assert(false); // should throw
+    } catch (const std::invalid_argument&) {
+    }
+
+    std::cout << "Bulk construction test passed.\n";
+}
+
+// Test the SNAP, Matrix Market, METIS and DIMACS readers
+void testGraphFormats() {
+    // SNAP: comments, tabs, CRLF, a duplicate edge, an extra column and no final newline
+    std::istringstream snap("# Directed graph\r\n# FromNodeId\tToNodeId\r\n0\t1\r\n1\t4\t1700000000\r\n\r\n0\t1\r\n4 2");
+    Graph g = Graph::readSNAP(snap);
+    assert(g.numVertices() == 5);
+    assert((g.neighbors(0) == std::vector<int>{1}));
+    assert((g.neighbors(1) == std::vector<int>{4}));
+    assert((g.neighbors(4) == std::vector<int>{2}));
+
+    // Matrix Market: 1-based, symmetric entries go both ways, values ignored
+    std::istringstream mm("%%MatrixMarket matrix coordinate real symmetric\n"
+                          "% a comment\n"
+                          "4 4 3\n"
+                          "2 1 0.5\n"
+                          "3 3 1.0\n"
+                          "4 2 -2e3\n");
+    g = Graph::readMatrixMarket(mm);
+    assert(g.numVertices() == 4);
+    assert((g.neighbors(0) == std::vector<int>{1}));
+    assert((g.neighbors(1) == std::vector<int>{0, 3}));
+    assert((g.neighbors(2) == std::vector<int>{2}));
+    assert((g.neighbors(3) == std::vector<int>{1}));
+
+    std::istringstream mmGeneral("%%MatrixMarket matrix coordinate pattern general\n2 3 2\n1 3\n2 1\n");
+    g = Graph::readMatrixMarket(mmGeneral);
+    assert(g.numVertices() == 3 && g.edgeIn(0, 2) && !g.edgeIn(2, 0) && g.edgeIn(1, 0));
+
+    // METIS with edge weights (fmt 001), a comment and an isolated vertex (empty line)
+    std::istringstream metis("% triangle plus an isolated vertex\n"
+                             "4 3 001\n"
+                             "2 5 3 7\n"
+                             "1 5 3 1\n"
+                             "1 7 2 1\n"
+                             "\n");
+    g = Graph::readMETIS(metis);
+    assert(g.numVertices() == 4);
+    assert((g.neighbors(0) == std::vector<int>{1, 2}));
+    assert((g.neighbors(1) == std::vector<int>{0, 2}));
+    assert((g.neighbors(2) == std::vector<int>{0, 1}));
+    assert(g.neighbors(3).empty());
+
+    // METIS with vertex sizes and two vertex weights per vertex (fmt 110, ncon 2)
+    std::istringstream metisVertex("2 1 110 2\n9 1 1 2\n9 1 1 1\n");
+    g = Graph::readMETIS(metisVertex);
+    assert(g.edgeIn(0, 1) && g.edgeIn(1, 0));
+
+    // DIMACS: a repeated arc keeps its first position and takes its last weight
+    std::istringstream dimacs("c sample\n"
+                              "p sp 3 4\n"
+                              "a 1 2 5\n"
+                              "a 1 3 2\n"
+                              "a 3 2 1\n"
+                              "a 1 2 4\n");
+    WeightedGraph<long long> road = WeightedGraph<long long>::readDIMACS(dimacs);
+    assert(road.numVertices() == 3);
+    assert((road.topology().neighbors(0) == std::vector<int>{1, 2}));
+    assert(road.weight(0, 1) == 4 && road.weight(0, 2) == 2 && road.weight(2, 1) == 1);
+    assert(road.dijkstra(0)[1].distance == 3);
+
+    // malformed inputs
+    std::string badSnap[] = {"0 1\nx y\n", "0\n"};
+    for (const std::string &text : badSnap) {
+        std::istringstream in(text);
+        try {
+            Graph::readSNAP(in);
+            assert(false); // should throw
+        } catch (const std::invalid_argument&) {
+        }
+    }
+    std::string badMM[] = {"not a banner\n1 1 0\n", "%%MatrixMarket matrix array real general\n2 2\n",
+                           "%%MatrixMarket matrix coordinate real general\n2 2 2\n1 1 1\n"};
+    for (const std::string &text : badMM) {
+        std::istringstream in(text);
+        try {
+            Graph::readMatrixMarket(in);
+            assert(false); // should throw
+        } catch (const std::invalid_argument&) {
+        }
+    }
+    std::string badMETIS[] = {"3 2\n2\n1\n", "2 1\n2\n1\n1\n", "2 1 001\n2\n1 1\n", "2 2\n2\n1\n"};
+    for (const std::string &text : badMETIS) {
+        std::istringstream in(text);
+        try {
+            Graph::readMETIS(in);
+            assert(false); // should throw
+        } catch (const std::invalid_argument&) {
+        }
+    }
+    std::string badDIMACS[] = {"a 1 2 3\n", "p sp 2 2\na 1 2 3\n", "p sp 2 1\nx 1 2 3\n", "p sp 2 1\na 1 2\n"};
+    for (const std::string &text : badDIMACS) {
+        std::istringstream in(text);
+        try {
+            WeightedGraph<int>::readDIMACS(in);
+            assert(false); // should throw
+        } catch (const std::invalid_argument&) {
+        }
+    }
+    // weights must fit an integer W
+    std::istringstream wide("p sp 2 1\na 1 2 8589934592\n");
+    try {
+        WeightedGraph<int>::readDIMACS(wide);
+        assert(false); // should throw
+    } catch (const std::out_of_range&) {
+    }
+    std::istringstream negative("p sp 2 1\na 1 2 -1\n");
+    try {
+        WeightedGraph<unsigned>::readDIMACS(negative);
+        assert(false); // should throw
+    } catch (const std::out_of_range&) {
+    }
+    std::istringstream wideDouble("p sp 2 1\na 1 2 8589934592\n");
+    assert(WeightedGraph<double>::readDIMACS(wideDouble).weight(0, 1) == 8589934592.0);
+
+    std::istringstream outside("%%MatrixMarket matrix coordinate real general\n2 2 1\n3 1 1\n");
+    try {
+        Graph::readMatrixMarket(outside);
+        assert(false); // should throw
+    } catch (const std::out_of_range&) {
+    }
+
+    // weighted bulk construction matches addEdge on random edges with repeats
+    int n = 500;
+    std::vector<std::pair<int, int> > edges = randomEdges(n, 40000, 31, 40);
+    std::vector<int> weights;
+    WeightedGraph<int> expected(n);
+    for (size_t i = 0; i < edges.size(); ++i) {
+        weights.push_back(i);
+        expected.addEdge(edges[i].first, edges[i].second, i);
+    }
+    WeightedGraph<int> bulk = WeightedGraph<int>::fromEdges(n, edges, weights, 4);
+    for (int u = 0; u < n; ++u) {
+        assert(bulk.topology().neighbors(u) == expected.topology().neighbors(u));
+        assert(bulk.weights(u) == expected.weights(u));
+    }
+
+    std::cout << "Graph format test passed.\n";
+}
+
+#ifdef GRAPH_WITH_ZLIB
+// Test the gzip loading pipeline against the in-memory parser
+void testReadGzip() {
+    const char *path = "readGzipTest.txt.gz";
+    auto writeGzip = [&](const std::string &text) {
+        gzFile out = gzopen(path, "wb");
+        gzwrite(out, text.data(), text.size());
+        gzclose(out);
+    };
+
+    // several 1 MB decompressed blocks, with blank lines, CRLF and repeated edges
+    int n = 20000;
+    long long m = 400000;
+    std::string text = "\n" + std::to_string(n) + " " + std::to_string(m) + "\r\n";
+    std::vector<std::pair<int, int> > edges = randomEdges(n, m, 77);
+    for (long long i = 0; i < m; ++i) {
+        int u = edges[i].first;
+        int v = i % 4 == 0 ? edges[i].second % 50 : edges[i].second;
+        text += std::to_string(u) + " " + std::to_string(v) + (i % 2 == 0 ? "\r\n" : "\n");
+        if (i % 5000 == 0) {
+            text += "\n";
+        }
+    }
+    Graph expected = Graph::readFromBuffer(text.data(), text.data() + text.size());
+
+    writeGzip(text);
+    for (int threads : {1, 2, 5}) {
+        Graph g = Graph::readGzip(path, threads);
+        assert(g.numVertices() == n);
+        for (int u = 0; u < n; ++u) {
+            assert(g.neighbors(u) == expected.neighbors(u));
+        }
+    }
+
+    // an uncompressed file is read as is
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "3 2\n0 1\n1 2\n";
+    }
+    Graph plain = Graph::readGzip(path);
+    assert(plain.edgeIn(0, 1) && plain.edgeIn(1, 2));
+
+    // bad lines after the first m edges are ignored
+    writeGzip("3 1\n0 1\n1 x\n2 7\n");
+    assert(Graph::readGzip(path, 3).edgeIn(0, 1));
+
+    std::string bad[] = {"", "3 3\n0 1\n1 2\n", "3 1\n0 1 2\n"};
+    for (const std::string &input : bad) {
+        writeGzip(input);
+        try {
+            Graph::readGzip(path, 3);
+            assert(false); // should throw
+        } catch (const std::invalid_argument&) {
+        }
+    }
+    writeGzip("3 1\n0 5\n");
+    try {
+        Graph::readGzip(path, 3);
+        assert(false); // should throw
+    } catch (const std::out_of_range&) {
+    }
+
+    // cut the compressed stream short
+    writeGzip(text);
+    std::string compressed;
+    {
+        std::ifstream in(path, std::ios::binary);
+        compressed.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(compressed.data(), compressed.size() / 2);
+    }
+    try {
+        Graph::readGzip(path, 3);
+        assert(false); // should throw
+    } catch (const std::runtime_error&) {
+    }
+    std::remove(path);
+
+    try {
+        Graph::readGzip("noSuchGraphFile.txt.gz");
+        assert(false); // should throw
+    } catch (const std::runtime_error&) {
+    }
+
+    std::cout << "Gzip read test passed.\n";
+}
+#endif
+
 // void testReadFromSTDIN(Graph& g) {
 //     std::cout << "Running readFromSTDIN() test...\n";
 
@@ -161,6 +1634,34 @@ int main() {
     testAssignmentOperator();
     testBFS();
     testDFS();
+    testFreeze();
+    testEdgeIndex();
+    testReadFromStream();
+    testDirectionOptimizingBFS();
+    testThreadTeam();
+    testParallelBFS();
+    testIterativeDFS();
+    testTraversalWorkspace();
+    testBFSFields();
+    testShortestPath();
+    testMultiSourceBFS();
+    testTopologicalSort();
+    testDagExecutor();
+    testIncrementalTopologicalOrder();
+    testStronglyConnectedComponents();
+    testWeaklyConnectedComponents();
+    testReachabilityIndex();
+    testDistanceIndex();
+    testDijkstra();
+    testDeltaStepping();
+    testDagPaths();
+    testMappedGraph();
+    testParallelRead();
+    testFromEdges();
+    testGraphFormats();
+#ifdef GRAPH_WITH_ZLIB
+    testReadGzip();
+#endif
 
     std::cout << "=======  All Graph Tests Passed Successfully!  ========\n";
     return 0;